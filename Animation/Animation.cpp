@@ -1,320 +1,680 @@
 #include "Animation.h"
 #include "..\\Graphics/GameObject.h"
 
-AnimationSystem::AnimationSystem()
+// Position / rotation / scale of the object, whichever the animation type changes
+static DirectX::XMFLOAT3 GetValue(const GameObject* gameObject, AnimationType type)
 {
-	deltaTimer.Start();
+	switch (type)
+	{
+	case AnimationType::Position:
+		return gameObject->GetPositionFloat3();
+	case AnimationType::Rotation:
+		return gameObject->GetRotationFloat3();
+	default:
+		return gameObject->GetScaleFloat3();
+	}
 }
 
-void AnimationSystem::Update()
+static float AnimationDistance(const GameObject* gameObject, AnimationType type, const DirectX::XMFLOAT3& targetFloat3)
 {
-	// List is empty, no work to be done
-	if (animationList.empty())
-		return;
+	/* Using Pythagorean Theorem to calculate the lenght from the target objects current position/rotation/scale to the target one
+	   distance = sqrt(lenghtX^2 + lenghtY^2) */
 
-	// Fixes framerate to value set in ANIMATION_FRAMERATE
-	if (deltaTimer.GetMilisecondsElapsed() < (1000 / ANIMATION_FRAMERATE)) // 1000ms / 60 = 60FPS
-		return;
+	// Global orentation used for rotations, so just keep gameobject at 0
+	DirectX::XMFLOAT3 gameObjectFloat3(0.0f, 0.0f, 0.0f);
+	if (type != AnimationType::Rotation)
+		gameObjectFloat3 = GetValue(gameObject, type);
+
+	return sqrt(((gameObjectFloat3.x - targetFloat3.x) * (gameObjectFloat3.x - targetFloat3.x)) +
+	            ((gameObjectFloat3.y - targetFloat3.y) * (gameObjectFloat3.y - targetFloat3.y)) +
+	            ((gameObjectFloat3.z - targetFloat3.z) * (gameObjectFloat3.z - targetFloat3.z)));
+}
+
+// Time to cover the distance at the given speed, the end is set exactly when it has passed
+static float AnimationDuration(const GameObject* gameObject, AnimationType type, float speed, const DirectX::XMFLOAT3& targetFloat3)
+{
+	if (speed <= 0.0f)
+		return 0.0f;
 
-	// Loops all currently active animations
-	for (size_t i = 0; i < animationList.size(); i++)
+	return (AnimationDistance(gameObject, type, targetFloat3) / speed) * 1000.0f;
+}
+
+/* Moves the animation dt miliseconds forward and returns the part of the target to apply for it.
+*  A continous animation wraps around, every loop it finished adds the whole target */
+static float Advance(AnimationProperty& animation, float dt)
+{
+	// Animation is so short it has no duration, the whole target is applied at once
+	if (animation.duration <= 0.0f)
 	{
-		auto* animation = animationList.at(i);
-		auto* targetObject = animation->Parameter().targetObject;
+		float remaining = 1.0f - animation.applied;
+		animation.progress = 1.0f;
+		animation.applied = 1.0f;
+		return remaining;
+	}
 
-		// Check if animation is currently running
-		if (animation->Parameter().state != AnimationState::Running)
-			return;
+	animation.elapsed += dt;
 
-		/* Incase animation distance is so small that it has less than 1 frame it will just
-		*  set the target object to target orientation and delete the animation */
-		if (animation->Parameter().numFrames == 0)
-		{
-			animation->SetState(AnimationState::Finished);
-			RemoveAnimation(animation);
-			continue;
-		}
+	float loops = 0.0f;
+	if (animation.continous && animation.elapsed >= animation.duration)
+	{
+		loops = floorf(animation.elapsed / animation.duration);
+		animation.elapsed -= loops * animation.duration;
+		animation.looped = true;
+	}
 
-		// Run a switch case on the type to determine which parameter to animate
-		switch (animation->Parameter().type)
-		{
-		case AnimationType::Position:
-		{
-			targetObject->AdjustPosition((animation->Parameter().targetFloat3.x / animation->Parameter().numFrames),
-				                         (animation->Parameter().targetFloat3.y / animation->Parameter().numFrames),
-				                         (animation->Parameter().targetFloat3.z / animation->Parameter().numFrames));
-			break;
-		}
+	animation.progress = fminf(animation.elapsed / animation.duration, 1.0f);
+	float eased = AnimationSystem::Ease(animation.easing, animation.progress);
+	float amount = loops + eased - animation.applied;
+	animation.applied = eased;
+	return amount;
+}
 
-		case AnimationType::Scale:
-		{
-			targetObject->AdjustScale((animation->Parameter().targetFloat3.x / animation->Parameter().numFrames),
-				                      (animation->Parameter().targetFloat3.y / animation->Parameter().numFrames),
-				                      (animation->Parameter().targetFloat3.z / animation->Parameter().numFrames));
-			break;
-		}
-		case AnimationType::Rotation:
-		{
-			targetObject->AdjustRotation((animation->Parameter().targetFloat3.x / animation->Parameter().numFrames),
-			                           	 (animation->Parameter().targetFloat3.y / animation->Parameter().numFrames),
-			                           	 (animation->Parameter().targetFloat3.z / animation->Parameter().numFrames));
-			break;
-		}
-		}
+/* Moves a track animation dt miliseconds forward. Returns true when a track that plays once is done,
+*  value is then the final value, otherwise it is the change since the last update */
+static bool AdvanceTrack(AnimationProperty& animation, float dt, DirectX::XMFLOAT3& value)
+{
+	const AnimationTrack* track = animation.track;
+	animation.elapsed += dt;
+	bool finished = (track->GetWrap() == TrackWrap::Once) && (animation.elapsed >= animation.duration);
+
+	// Wrapping only moves the elapsed time back when a loop was completed
+	float elapsed = animation.elapsed;
+	float time = track->Wrap(animation.elapsed);
+	if (animation.elapsed < elapsed)
+		animation.looped = true;
+	animation.progress = (animation.duration > 0.0f) ? fminf(time / animation.duration, 1.0f) : 1.0f;
+	DirectX::XMFLOAT3 sample = track->Evaluate(time, animation.cursor);
+
+	if (finished)
+	{
+		animation.progress = 1.0f;
+		value = DirectX::XMFLOAT3(animation.start.x + sample.x, animation.start.y + sample.y, animation.start.z + sample.z);
+		return true;
+	}
 
-		// If animation is not continous it will finish and delete the animation data when the last frame is done
-		if ((animation->Parameter().currentFrame >= animation->Parameter().numFrames) && !animation->Parameter().continous)
-		{
-			SetFinalTarget(animation);
-			animation->SetState(AnimationState::Finished);
-			RemoveAnimation(animation);
-		}
+	// Target holds the track value applied so far
+	value = DirectX::XMFLOAT3(sample.x - animation.target.x, sample.y - animation.target.y, sample.z - animation.target.z);
+	animation.target = sample;
+	return false;
+}
+
+// Adds value to or sets it as the position / rotation / scale of the object
+static void ApplyChannel(GameObject* gameObject, AnimationType type, bool isFinal, const DirectX::XMFLOAT3& value)
+{
+	switch (type)
+	{
+	case AnimationType::Position:
+		if (isFinal)
+			gameObject->SetPosition(value);
 		else
-		{
-			animation->NextFrame();
-		}
+			gameObject->AdjustPosition(value.x, value.y, value.z);
+		break;
+	case AnimationType::Scale:
+		if (isFinal)
+			gameObject->SetScale(value);
+		else
+			gameObject->AdjustScale(value.x, value.y, value.z);
+		break;
+	case AnimationType::Rotation:
+		if (isFinal)
+			gameObject->SetRotation(value);
+		else
+			gameObject->AdjustRotation(value.x, value.y, value.z);
+		break;
 	}
-	deltaTimer.Restart();
 }
 
-void AnimationSystem::PauseAllAnimations()
+void AnimationSystem::Update(float dt)
 {
-	if (animationList.empty())
+	PROFILE_ZONE("AnimationSystem::Update");
+
+	size_t animationCount = GetAnimationCount();
+	if (animationCount == 0)
 		return;
 
-	for (size_t i = 0; i < animationList.size(); i++)
-	{
-		// If animation was finished, dont change its status to prevent it from being deleted
-		if (animationList.at(i)->Parameter().state == AnimationState::Finished)
-			continue;
+	// Every animation writes the change it makes into the slot of its object
+	EvaluateJob job;
+	job.system = this;
+	job.dt = dt;
+	Run(animationCount, EvaluateChunk, &job);
 
-		animationList.at(i)->Pause();
-	}
+	// Objects are split between the threads instead of animations, so no object is changed by two at once
+	Run(objects.size(), ApplyChunk, this);
+
+	if (eventCount.load() > 0)
+		HandleEvents();
 }
 
-void AnimationSystem::ResumeAllAnimations()
+void AnimationSystem::Reserve(size_t count)
 {
-	if (animationList.empty())
-		return;
+	for (int i = 0; i < ANIMATION_TYPE_COUNT; i++)
+		pools[i].reserve(count);
+	slots.reserve(count);
+	freeSlots.reserve(count);
+	objects.reserve(count);
+	objectIndex.reserve(count);
+}
 
-	for (size_t i = 0; i < animationList.size(); i++)
-	{
-		// If animation was finished, dont change its status to prevent it from being deleted
-		if (animationList.at(i)->Parameter().state == AnimationState::Finished)
-			continue;
+// Pool used to update large numbers of animations in parallel, nullptr updates everything on the calling thread
+void AnimationSystem::SetWorkerPool(WorkerPool* workers)
+{
+	this->workers = workers;
+}
 
-		animationList.at(i)->Resume();
+void AnimationSystem::PauseAllAnimations()
+{
+	for (int i = 0; i < ANIMATION_TYPE_COUNT; i++)
+	{
+		for (size_t j = 0; j < pools[i].size(); j++)
+		{
+			// If animation was finished, dont change its status to prevent it from being deleted
+			if (pools[i][j].state == AnimationState::Running)
+				pools[i][j].state = AnimationState::Paused;
+		}
 	}
 }
 
-AnimationProperty* AnimationSystem::CreateAnimation(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMFLOAT3 targetFloat3, bool continous)
+void AnimationSystem::ResumeAllAnimations()
 {
-	if (targetObject->IsAnimationActive())
-		return nullptr;
+	for (int i = 0; i < ANIMATION_TYPE_COUNT; i++)
+	{
+		for (size_t j = 0; j < pools[i].size(); j++)
+		{
+			// If animation was finished, dont change its status to prevent it from being deleted
+			if (pools[i][j].state == AnimationState::Paused)
+				pools[i][j].state = AnimationState::Running;
+		}
+	}
+}
 
+AnimationHandle AnimationSystem::CreateAnimation(GameObject* targetObject, AnimationType type, float speed, const DirectX::XMFLOAT3 targetFloat3, bool continous, AnimationEasing easing)
+{
 	if (targetObject == nullptr)
-		return nullptr;
+		return AnimationHandle();
+
+	AnimationProperty animation;
+	animation.target = targetFloat3;
+	animation.easing = easing;
+	animation.continous = continous;
+	animation.duration = AnimationDuration(targetObject, type, speed, targetFloat3);
+	return Add(targetObject, type, animation);
+}
 
-	// Create new animation object
-	auto* animation = new AnimationProperty(targetObject, type, speed, targetFloat3, continous);
-	targetObject->SetAnimationActive(true);
-	animationList.push_back(animation);
-	return animation;
+// Follows a track that can be shared with other animations, phase is how many miliseconds into the track it starts
+AnimationHandle AnimationSystem::CreateAnimation(GameObject* targetObject, AnimationType type, const AnimationTrack* track, float phase)
+{
+	if (targetObject == nullptr || track == nullptr)
+		return AnimationHandle();
+
+	AnimationProperty animation;
+	animation.track = track;
+	animation.target = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+	animation.continous = track->GetWrap() != TrackWrap::Once;
+	animation.duration = track->GetDuration();
+	animation.elapsed = phase;
+	return Add(targetObject, type, animation);
 }
 
-AnimationProperty* AnimationSystem::CreateAnimation(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMVECTOR targetVector, bool continous)
+AnimationHandle AnimationSystem::CreateAnimation(GameObject* targetObject, AnimationType type, float speed, const DirectX::XMVECTOR targetVector, bool continous, AnimationEasing easing)
 {
-	if (targetObject->IsAnimationActive())
-		return nullptr;
+	DirectX::XMFLOAT3 targetFloat3;
+	DirectX::XMStoreFloat3(&targetFloat3, targetVector);
+	return CreateAnimation(targetObject, type, speed, targetFloat3, continous, easing);
+}
 
-	if (targetObject == nullptr)
-		return nullptr;
+/* Restarts the animation from where its object is now towards a new target, keeping its handle, state and easing.
+*  Nothing is created or removed, so it can be called every tick for an object that keeps changing direction */
+bool AnimationSystem::Retarget(AnimationHandle handle, float speed, const DirectX::XMFLOAT3& targetFloat3)
+{
+	// Track animations follow their keys and have no target to change
+	AnimationProperty* animation = Find(handle);
+	if (animation == nullptr || animation->track != nullptr)
+		return false;
 
-	// Create new animation object
-	auto* animation = new AnimationProperty(targetObject, type, speed, targetVector, continous);
-	targetObject->SetAnimationActive(true);
-	animationList.push_back(animation);
-	return animation;
+	AnimationType type = slots[handle.slot].type;
+	animation->start = GetValue(animation->targetObject, type);
+	animation->target = targetFloat3;
+	animation->duration = AnimationDuration(animation->targetObject, type, speed, targetFloat3);
+	animation->elapsed = 0.0f;
+	animation->progress = 0.0f;
+	animation->applied = 0.0f;
+	return true;
 }
 
-bool AnimationSystem::RemoveAnimation(AnimationProperty* animation)
+bool AnimationSystem::Start(AnimationHandle handle)
 {
+	AnimationProperty* animation = Find(handle);
 	if (animation == nullptr)
 		return false;
 
-	// Loops animation list to get animation pointer by pointer
-	std::vector<AnimationProperty*>::iterator it;
-	for (it = animationList.begin(); it != animationList.end(); it++)
-	{
-		if (*it == animation) // Animation found - deleting
-		{
-			animation->Parameter().targetObject->SetAnimationActive(false);
-			animationList.erase(it);
-			delete animation;
-			animation = nullptr;
-			return true;
-		}
-	}
+	animation->state = AnimationState::Running;
+	PushEvent(AnimationEventType::Started, *animation);
+	return true;
+}
 
-	return false;
+bool AnimationSystem::Pause(AnimationHandle handle)
+{
+	AnimationProperty* animation = Find(handle);
+	if (animation == nullptr)
+		return false;
+
+	animation->state = AnimationState::Paused;
+	return true;
+}
+
+bool AnimationSystem::Resume(AnimationHandle handle)
+{
+	AnimationProperty* animation = Find(handle);
+	if (animation == nullptr)
+		return false;
+
+	animation->state = AnimationState::Running;
+	return true;
+}
+
+// Number handed back in the events of the animation, so game code can tell what the animation was for
+bool AnimationSystem::SetTag(AnimationHandle handle, uint32_t tag)
+{
+	AnimationProperty* animation = Find(handle);
+	if (animation == nullptr)
+		return false;
+
+	animation->tag = tag;
+	return true;
+}
+
+// Takes the oldest event, false when there are none. Should be read until empty every frame
+bool AnimationSystem::PollEvent(AnimationEvent& event)
+{
+	return events.Pop(event);
+}
+
+// Events pushed out of the full queue before anybody read them
+uint32_t AnimationSystem::GetDroppedEventCount() const
+{
+	return events.GetDroppedCount();
+}
+
+bool AnimationSystem::RemoveAnimation(AnimationHandle handle)
+{
+	if (!IsValid(handle))
+		return false;
+
+	const Slot& slot = slots[handle.slot];
+	Remove(slot.type, slot.index);
+	return true;
 }
 
 bool AnimationSystem::RemoveAnimation(GameObject* parentObject)
 {
-	if (parentObject == nullptr)
+	auto it = objectIndex.find(parentObject);
+	if (it == objectIndex.end())
 		return false;
 
-	// Loops animation list to get animation pointer by object
-	std::vector<AnimationProperty*>::iterator it;
-	for (it = animationList.begin(); it != animationList.end(); it++)
+	// Removes the animation on every channel of the object
+	uint32_t objectSlot = it->second;
+	bool removed = false;
+	for (int i = 0; i < ANIMATION_TYPE_COUNT; i++)
 	{
-		auto* ptr = *it;
-		if (ptr->Parameter().targetObject == parentObject)
+		uint32_t slot = objects[objectSlot].slot[i];
+		if (slot == ANIMATION_NONE)
+			continue;
+
+		Remove(static_cast<AnimationType>(i), slots[slot].index);
+		removed = true;
+	}
+
+	// Forgets the object, the last object is swapped into its place and its animations pointed at the new index
+	if (objectSlot != objects.size() - 1)
+	{
+		objects[objectSlot] = objects.back();
+		AnimatedObject& moved = objects[objectSlot];
+		objectIndex[moved.object] = objectSlot;
+		for (int i = 0; i < ANIMATION_TYPE_COUNT; i++)
 		{
-			animationList.erase(it);
-			*it = nullptr;
-			delete *it;
-			return true;
+			if (moved.slot[i] != ANIMATION_NONE)
+				pools[i][slots[moved.slot[i]].index].object = objectSlot;
 		}
 	}
+	objects.pop_back();
+	objectIndex.erase(parentObject);
+	return removed;
+}
 
-	return false;
+bool AnimationSystem::RemoveAnimation(GameObject* parentObject, AnimationType type)
+{
+	AnimationHandle handle = GetAnimation(parentObject, type);
+	return RemoveAnimation(handle);
 }
 
-void AnimationSystem::SetFinalTarget(AnimationProperty* animation)
+AnimationHandle AnimationSystem::GetAnimation(const GameObject* targetObject, AnimationType type) const
 {
-	/* Sets the final position / scale / rotation data to the actual target, this is done when animation is complete.
-	*  Must be done due to precision errors in animation  */
+	AnimationHandle handle;
+	auto it = objectIndex.find(targetObject);
+	if (it == objectIndex.end())
+		return handle;
+
+	handle.slot = objects[it->second].slot[static_cast<int>(type)];
+	if (handle.slot != ANIMATION_NONE)
+		handle.generation = slots[handle.slot].generation;
+	return handle;
+}
 
-	auto* gameObject = animation->Parameter().targetObject;
-	DirectX::XMFLOAT3 startData;
-	DirectX::XMFLOAT3 finalData = animation->Parameter().targetFloat3;
-	
-	switch (animation->Parameter().type)
-	{
-	case AnimationType::Position:
+bool AnimationSystem::IsValid(AnimationHandle handle) const
+{
+	return Find(handle) != nullptr;
+}
+
+// Normalized progress of the current run, 1 for an animation that is finished or removed
+float AnimationSystem::GetProgress(AnimationHandle handle) const
+{
+	const AnimationProperty* animation = Find(handle);
+	if (animation == nullptr)
+		return 1.0f;
+
+	return animation->progress;
+}
+
+size_t AnimationSystem::GetAnimationCount() const
+{
+	size_t count = 0;
+	for (int i = 0; i < ANIMATION_TYPE_COUNT; i++)
+		count += pools[i].size();
+	return count;
+}
+
+float AnimationSystem::Ease(AnimationEasing easing, float progress)
+{
+	switch (easing)
 	{
-		startData = animation->StartValues().position;
-		gameObject->SetPosition(startData.x + finalData.x, startData.y + finalData.y, startData.z + finalData.z);
-		break;
+	case AnimationEasing::EaseIn:
+		return progress * progress;
+	case AnimationEasing::EaseOut:
+		return progress * (2.0f - progress);
+	case AnimationEasing::EaseInOut:
+		return progress * progress * (3.0f - (2.0f * progress));
+	default:
+		return progress;
 	}
-	case AnimationType::Rotation:
+}
+
+// Only one animation per channel, a running one is changed with Retarget
+AnimationHandle AnimationSystem::Add(GameObject* targetObject, AnimationType type, AnimationProperty& animation)
+{
+	AnimationHandle handle;
+	auto it = objectIndex.find(targetObject);
+	if (it == objectIndex.end())
 	{
-		startData = animation->StartValues().rotation;
-		gameObject->SetRotation(startData.x + finalData.x, startData.y + finalData.y, startData.z + finalData.z);
-		break;
+		it = objectIndex.insert(std::make_pair(targetObject, static_cast<uint32_t>(objects.size()))).first;
+		objects.push_back(AnimatedObject());
+		objects.back().object = targetObject;
 	}
-	case AnimationType::Scale:
+
+	AnimatedObject& animatedObject = objects[it->second];
+	if (animatedObject.slot[static_cast<int>(type)] != ANIMATION_NONE)
+		return handle;
+
+	// Reuses a slot of a removed animation before growing the slot table
+	if (freeSlots.empty())
 	{
-		startData = animation->StartValues().scale;
-		gameObject->SetScale(startData.x + finalData.x, startData.y + finalData.y, startData.z + finalData.z);
-		break;
-		break;
+		handle.slot = static_cast<uint32_t>(slots.size());
+		slots.push_back(Slot());
 	}
+	else
+	{
+		handle.slot = freeSlots.back();
+		freeSlots.pop_back();
 	}
+
+	std::vector<AnimationProperty>& pool = pools[static_cast<int>(type)];
+	Slot& slot = slots[handle.slot];
+	slot.type = type;
+	slot.index = static_cast<uint32_t>(pool.size());
+	handle.generation = slot.generation;
+
+	animation.targetObject = targetObject;
+	animation.start = GetValue(targetObject, type);
+	animation.slot = handle.slot;
+	animation.object = it->second;
+
+	pool.push_back(animation);
+	animatedObject.slot[static_cast<int>(type)] = handle.slot;
+	return handle;
 }
 
-AnimationProperty::AnimationProperty(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMFLOAT3& targetFloat3, bool continous)
+/* Advances the animations from begin to end, counted through the pools one type after the other.
+*  Only the animation itself and its channel in the object slot are written */
+void AnimationSystem::EvaluateChunk(void* context, size_t begin, size_t end)
 {
-	parameter.targetFloat3 = targetFloat3;
-	parameter.targetVector = DirectX::XMLoadFloat3(&parameter.targetFloat3);
+	PROFILE_ZONE("AnimationSystem::EvaluateChunk");
 
-	// Setting properties of the animation
-	SetProperties(targetObject, type, speed, continous);
+	EvaluateJob* job = static_cast<EvaluateJob*>(context);
+	AnimationSystem* system = job->system;
+
+	size_t poolStart = 0;
+	for (int type = 0; type < ANIMATION_TYPE_COUNT; type++)
+	{
+		std::vector<AnimationProperty>& pool = system->pools[type];
+		size_t first = (begin > poolStart) ? begin - poolStart : 0;
+		size_t last = (end < poolStart + pool.size()) ? end - poolStart : pool.size();
+		poolStart += pool.size();
+
+		for (size_t i = first; i < last; i++)
+		{
+			AnimationProperty& animation = pool[i];
+
+			// Check if animation is currently running
+			if (animation.state != AnimationState::Running)
+				continue;
+
+			AnimatedObject& animatedObject = system->objects[animation.object];
+			DirectX::XMFLOAT3& value = animatedObject.value[type];
+
+			if (animation.track != nullptr)
+			{
+				bool finished = AdvanceTrack(animation, job->dt, value);
+				animatedObject.change[type] = finished ? ChannelChange::Set : ChannelChange::Adjust;
+				if (finished)
+					animation.state = AnimationState::Finished;
+				if (finished || animation.looped)
+					system->eventCount.fetch_add(1);
+				continue;
+			}
+
+			// Part of the target to move this update, follows the easing curve over the duration
+			float amount = Advance(animation, job->dt);
+			if (animation.looped)
+				system->eventCount.fetch_add(1);
+
+			/* If animation is not continous it will finish when the duration has passed, the final value is set
+			*  instead of the last change to get rid of the precision errors of adding them up */
+			if (animation.progress >= 1.0f && !animation.continous)
+			{
+				value = DirectX::XMFLOAT3(animation.start.x + animation.target.x, animation.start.y + animation.target.y, animation.start.z + animation.target.z);
+				animatedObject.change[type] = ChannelChange::Set;
+				animation.state = AnimationState::Finished;
+				system->eventCount.fetch_add(1);
+				continue;
+			}
+
+			value = DirectX::XMFLOAT3(animation.target.x * amount, animation.target.y * amount, animation.target.z * amount);
+			animatedObject.change[type] = ChannelChange::Adjust;
+		}
+
+		if (end <= poolStart)
+			return;
+	}
 }
 
-AnimationProperty::AnimationProperty(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMVECTOR& targetVector, bool continous)
+// Applies the changes written to the slots of the objects from begin to end and clears them
+void AnimationSystem::ApplyChunk(void* context, size_t begin, size_t end)
 {
-	// Sets up new animation parameters
-	parameter.targetVector = targetVector;
+	PROFILE_ZONE("AnimationSystem::ApplyChunk");
 
-	DirectX::XMStoreFloat3(&parameter.targetFloat3, parameter.targetVector);
+	AnimationSystem* system = static_cast<AnimationSystem*>(context);
+	for (size_t i = begin; i < end; i++)
+	{
+		AnimatedObject& animatedObject = system->objects[i];
+		for (int type = 0; type < ANIMATION_TYPE_COUNT; type++)
+		{
+			if (animatedObject.change[type] == ChannelChange::None)
+				continue;
 
-	// Setting properties of the animation
-	SetProperties(targetObject, type, speed, continous);
+			ApplyChannel(animatedObject.object, static_cast<AnimationType>(type), animatedObject.change[type] == ChannelChange::Set, animatedObject.value[type]);
+			animatedObject.change[type] = ChannelChange::None;
+		}
+	}
 }
 
-void AnimationProperty::Start()
+void AnimationSystem::Run(size_t count, WorkerFunction function, void* context)
 {
-	parameter.state = AnimationState::Running;
+	// Below the threshold waking the workers costs more than the work
+	if (workers == nullptr || count < ANIMATION_PARALLEL_THRESHOLD)
+		function(context, 0, count);
+	else
+		workers->ParallelFor(count, ANIMATION_CHUNK_SIZE, function, context);
 }
 
-void AnimationProperty::Pause()
+/* Queues the events of the animations that looped or finished during the update and removes the finished ones.
+*  Done on the calling thread in pool order, so the events come in the same order however the update was split */
+void AnimationSystem::HandleEvents()
 {
-	parameter.state = AnimationState::Paused;
+	for (int type = 0; type < ANIMATION_TYPE_COUNT; type++)
+	{
+		std::vector<AnimationProperty>& pool = pools[type];
+		size_t i = 0;
+		while (i < pool.size())
+		{
+			AnimationProperty& animation = pool[i];
+			if (animation.looped)
+			{
+				PushEvent(AnimationEventType::Looped, animation);
+				animation.looped = false;
+			}
+
+			// The last animation is swapped into this index, so it is checked next without moving i
+			if (animation.state == AnimationState::Finished)
+			{
+				PushEvent(AnimationEventType::Finished, animation);
+				Remove(static_cast<AnimationType>(type), static_cast<uint32_t>(i));
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+	eventCount.store(0);
 }
 
-void AnimationProperty::Resume()
+void AnimationSystem::PushEvent(AnimationEventType type, const AnimationProperty& animation)
 {
-	parameter.state = AnimationState::Running;
+	AnimationEvent event;
+	event.type = type;
+	event.handle.slot = animation.slot;
+	event.handle.generation = slots[animation.slot].generation;
+	event.targetObject = animation.targetObject;
+	event.animationType = slots[animation.slot].type;
+	event.tag = animation.tag;
+	events.Push(event);
 }
 
-void AnimationProperty::SetState(AnimationState state)
+AnimationProperty* AnimationSystem::Find(AnimationHandle handle)
 {
-	parameter.state = state;
+	if (handle.slot >= slots.size())
+		return nullptr;
+
+	const Slot& slot = slots[handle.slot];
+	if (slot.generation != handle.generation || slot.index == ANIMATION_NONE)
+		return nullptr;
+
+	return &pools[static_cast<int>(slot.type)][slot.index];
 }
 
-void AnimationProperty::NextFrame()
+const AnimationProperty* AnimationSystem::Find(AnimationHandle handle) const
 {
-	parameter.currentFrame++;
+	if (handle.slot >= slots.size())
+		return nullptr;
+
+	const Slot& slot = slots[handle.slot];
+	if (slot.generation != handle.generation || slot.index == ANIMATION_NONE)
+		return nullptr;
+
+	return &pools[static_cast<int>(slot.type)][slot.index];
 }
 
-AnimationProperty::StartValuesStruct AnimationProperty::StartValues()
+// Swaps the last animation of the pool into the removed index, the order of the pool is not kept
+void AnimationSystem::Remove(AnimationType type, uint32_t index)
 {
-	return startValue;
+	std::vector<AnimationProperty>& pool = pools[static_cast<int>(type)];
+	AnimationProperty& animation = pool[index];
+
+	// Frees the channel, the object itself is kept in the object slots
+	objects[animation.object].slot[static_cast<int>(type)] = ANIMATION_NONE;
+
+	// Old handles to this slot stop matching
+	Slot& slot = slots[animation.slot];
+	slot.index = ANIMATION_NONE;
+	slot.generation++;
+	freeSlots.push_back(animation.slot);
+
+	if (index != pool.size() - 1)
+	{
+		animation = pool.back();
+		slots[animation.slot].index = index;
+	}
+	pool.pop_back();
 }
 
-AnimationProperty::ParametersStruct AnimationProperty::Parameter()
+AnimationEventQueue::AnimationEventQueue(size_t capacity)
 {
-	return parameter;
+	events.resize(capacity);
 }
 
-void AnimationProperty::CalculateAnimationDistance()
+// Adds the event at the back, a full queue drops its oldest event to make room. False if one was dropped
+bool AnimationEventQueue::Push(const AnimationEvent& event)
 {
-	/* Using Pythagorean Theorem to calculate the lenght from the target objects current position/rotation/scale to the target one
-	   distance = sqrt(lenghtX^2 + lenghtY^2) */
-
-	DirectX::XMFLOAT3 gameObjectFloat3(0.0f, 0.0f, 0.0f);
-
-	// Get the current type of animation
-	switch (parameter.type)
+	bool full = count == events.size();
+	if (full)
 	{
-	case AnimationType::Position:
-		gameObjectFloat3 = parameter.targetObject->GetPositionFloat3();
-		break;
-	case AnimationType::Rotation:
-		//gameObjectFloat3 = animation.targetObject->GetRotationFloat3(); 
-		// global orentation used, so just keep gameobject at 0
-		break;
-	case AnimationType::Scale:
-		gameObjectFloat3 = parameter.targetObject->GetScaleFloat3();
-		break;
+		head = (head + 1) % events.size();
+		count--;
+		dropped++;
 	}
 
-	DirectX::XMFLOAT3 targetFloat3 = parameter.targetFloat3;
+	events[(head + count) % events.size()] = event;
+	count++;
+	return !full;
+}
+
+bool AnimationEventQueue::Pop(AnimationEvent& event)
+{
+	if (count == 0)
+		return false;
 
-	parameter.animationDistance = sqrt(((gameObjectFloat3.x - targetFloat3.x) * (gameObjectFloat3.x - targetFloat3.x)) +
-	                                   ((gameObjectFloat3.y - targetFloat3.y) * (gameObjectFloat3.y - targetFloat3.y)) +
-	                     	           ((gameObjectFloat3.z - targetFloat3.z) * (gameObjectFloat3.z - targetFloat3.z)));
+	event = events[head];
+	head = (head + 1) % events.size();
+	count--;
+	return true;
 }
 
-void AnimationProperty::SetProperties(GameObject* targetObject, AnimationType type, int speed, bool continous)
+void AnimationEventQueue::Clear()
 {
-	// Sets up new animation parameters
-	parameter.targetObject = targetObject;
-	parameter.type = type;
-	parameter.speed = speed;
-	parameter.continous = continous;
-	parameter.state = AnimationState::Paused;
+	head = 0;
+	count = 0;
+}
 
-	// Setting start values
-	startValue.position = targetObject->GetPositionFloat3();
-	startValue.rotation = targetObject->GetRotationFloat3();
-	startValue.scale = targetObject->GetScaleFloat3();
+bool AnimationEventQueue::IsEmpty() const
+{
+	return count == 0;
+}
 
-	CalculateAnimationDistance();
+size_t AnimationEventQueue::Size() const
+{
+	return count;
+}
 
-	// Calculates the number of frame of the animation
-	float frames = static_cast<float>((parameter.animationDistance / static_cast<float>(speed))) * ANIMATION_FRAMERATE;
-	parameter.numFrames = (int)frames; // Precision loss is handled when animation is complete
+uint32_t AnimationEventQueue::GetDroppedCount() const
+{
+	return dropped;
 }
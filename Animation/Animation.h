@@ -1,91 +1,214 @@
 #pragma once
 #include <DirectXMath.h>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
-#include "..\\Timer.h"
+#include "AnimationTrack.h"
+#include "..\\Profiler\Profiler.h"
+#include "..\\Threading\WorkerPool.h"
 
-constexpr int ANIMATION_FRAMERATE = 60; // Framerate of the running animations(FPS)
-
-class AnimationProperty;
 class GameObject;
 
+constexpr uint32_t ANIMATION_NONE = 0xFFFFFFFF; // Pool index of a handle slot that is not in use
+constexpr size_t ANIMATION_PARALLEL_THRESHOLD = 4096; // Fewer animations than this are updated on the calling thread
+constexpr size_t ANIMATION_CHUNK_SIZE = 1024;         // Animations or objects per job given to a worker
+constexpr size_t ANIMATION_EVENT_CAPACITY = 1024;     // Events that can wait in the queue before the oldest are dropped
+
 enum class AnimationType {
 	Scale,
 	Position,
 	Rotation
 };
 
+constexpr int ANIMATION_TYPE_COUNT = 3;
+
 enum class AnimationState {
 	Running,
 	Paused,
-	Finished // Use for event system later
+	Finished // Reported with an AnimationEventType::Finished event, then removed
+};
+
+// Maps linear progress (0 - 1) to the progress applied to the target, every curve starts at 0 and ends at 1
+enum class AnimationEasing {
+	Linear,
+	EaseIn,
+	EaseOut,
+	EaseInOut
+};
+
+/* Refers to an animation in the AnimationSystem. The generation changes every time the slot is
+*  reused, so a handle to a finished or removed animation stays invalid instead of pointing at another one */
+struct AnimationHandle
+{
+	uint32_t slot = ANIMATION_NONE;
+	uint32_t generation = 0;
+};
+
+enum class AnimationEventType {
+	Started,
+	Finished,
+	Looped // A continous animation or looping track went past its end and started over
 };
 
+struct AnimationEvent
+{
+	AnimationEventType type = AnimationEventType::Started;
+	AnimationHandle handle; // No longer valid in a Finished event, only for comparing with the one kept by the caller
+	GameObject* targetObject = nullptr;
+	AnimationType animationType = AnimationType::Position;
+	uint32_t tag = 0; // Set with AnimationSystem::SetTag
+};
+
+/* Events in the order they happened, in a ring buffer that is allocated once.
+*  When it is full the oldest event is dropped and counted, nothing is allocated to make room.
+*  A queue nobody reads so always holds the latest events instead of filling up with old ones */
+class AnimationEventQueue
+{
+public:
+	AnimationEventQueue(size_t capacity);
+
+	bool Push(const AnimationEvent& event);
+	bool Pop(AnimationEvent& event);
+	void Clear();
+
+	bool IsEmpty() const;
+	size_t Size() const;
+	uint32_t GetDroppedCount() const;
+
+private:
+	std::vector<AnimationEvent> events;
+	size_t head = 0;  // Index of the oldest event
+	size_t count = 0;
+	uint32_t dropped = 0;
+};
+
+// Everything one animation needs, stored by value in the pool of its type
+struct AnimationProperty
+{
+	GameObject* targetObject = nullptr;
+	DirectX::XMFLOAT3 start;  // Position / rotation / scale of the target object when created
+	DirectX::XMFLOAT3 target; // Change from the start over the whole animation, for a track the track value applied so far
+	const AnimationTrack* track = nullptr; // Keys followed instead of the target, owned by the caller
+	uint32_t cursor = 0;                   // Key of the track the animation was at last
+	uint32_t tag = 0;
+	bool looped = false; // Went past its end during the current update, cleared once the event is queued
+
+	float duration = 0.0f;  // Miliseconds from start to target
+	float elapsed = 0.0f;   // Miliseconds into the current run (or loop of a continous animation)
+	float progress = 0.0f;  // elapsed / duration, 0 - 1
+	float applied = 0.0f;   // Eased progress already applied to the target object
+
+	AnimationEasing easing = AnimationEasing::Linear;
+	AnimationState state = AnimationState::Paused;
+	bool continous = false;
+	uint32_t slot = ANIMATION_NONE;   // Handle slot pointing at this animation
+	uint32_t object = ANIMATION_NONE; // Index of the target object in the object slots of the system
+};
+
+/* Animations are driven by elapsed time, not by counting frames. Every update moves each running
+*  animation to where it should be after dt, so they keep their schedule at any framerate and land
+*  exactly on their target when done.
+*
+*  Animations live by value in one contiguous pool per AnimationType, so the update is a straight pass
+*  over each pool with no allocations. Removing swaps the last animation of the pool into the hole and
+*  handles find their animation through a slot table that is fixed up when that happens.
+*
+*  Every object has one channel per AnimationType, so a position, a rotation and a scale animation can run
+*  on it at the same time. The channels are found through a hash of the object, which makes looking up,
+*  retargeting or cancelling the animation of an object independent of how many animations there are.
+*
+*  An update first evaluates every animation and writes the change it makes into the slot of its object,
+*  then applies the slots to the objects. With a WorkerPool set both passes are split into chunks across
+*  its threads once there are enough animations. Evaluating only writes to the animation and its own channel
+*  of the slot, and applying gives each object to a single thread, so the result does not depend on how the
+*  work was split and is the same as updating on one thread. */
 class AnimationSystem
 {
 public:
-	AnimationSystem();
-	void Update();
+	void Update(float dt);
+	void Reserve(size_t count);
+	void SetWorkerPool(WorkerPool* workers);
 
 	void PauseAllAnimations();
 	void ResumeAllAnimations();
 
-	AnimationProperty* CreateAnimation(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMFLOAT3 targetFloat3, bool continous = false);
-	AnimationProperty* CreateAnimation(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMVECTOR targetVector, bool continous = false);
+	// Speed is in units (or radians for rotations) per second, the duration comes from the distance to the target
+	AnimationHandle CreateAnimation(GameObject* targetObject, AnimationType type, float speed, const DirectX::XMFLOAT3 targetFloat3, bool continous = false, AnimationEasing easing = AnimationEasing::Linear);
+	AnimationHandle CreateAnimation(GameObject* targetObject, AnimationType type, float speed, const DirectX::XMVECTOR targetVector, bool continous = false, AnimationEasing easing = AnimationEasing::Linear);
+	AnimationHandle CreateAnimation(GameObject* targetObject, AnimationType type, const AnimationTrack* track, float phase = 0.0f);
 
-	bool RemoveAnimation(AnimationProperty* animation);
-	bool RemoveAnimation(GameObject* parentObject);
+	bool Retarget(AnimationHandle handle, float speed, const DirectX::XMFLOAT3& targetFloat3);
 
-private:
-	void SetFinalTarget(AnimationProperty* animation);
+	bool Start(AnimationHandle handle);
+	bool Pause(AnimationHandle handle);
+	bool Resume(AnimationHandle handle);
 
-	Timer deltaTimer;
+	bool SetTag(AnimationHandle handle, uint32_t tag);
+	bool PollEvent(AnimationEvent& event);
+	uint32_t GetDroppedEventCount() const;
 
-	std::vector<AnimationProperty*> animationList;
-};
+	bool RemoveAnimation(AnimationHandle handle);
+	bool RemoveAnimation(GameObject* parentObject);
+	bool RemoveAnimation(GameObject* parentObject, AnimationType type);
 
-class AnimationProperty
-{
-public:
-	struct StartValuesStruct {
-		DirectX::XMFLOAT3 position;
-		DirectX::XMFLOAT3 rotation;
-		DirectX::XMFLOAT3 scale;
-	};
+	AnimationHandle GetAnimation(const GameObject* targetObject, AnimationType type) const;
+	bool IsValid(AnimationHandle handle) const;
+	float GetProgress(AnimationHandle handle) const;
+	size_t GetAnimationCount() const;
 
-	struct ParametersStruct {
-		GameObject* targetObject;
-		DirectX::XMFLOAT3 targetFloat3;
-		DirectX::XMVECTOR targetVector;
+	static float Ease(AnimationEasing easing, float progress);
 
-		AnimationType type;
-		AnimationState state = AnimationState::Paused;
+private:
+	struct Slot
+	{
+		AnimationType type = AnimationType::Position;
+		uint32_t index = ANIMATION_NONE; // Position in the pool of its type
+		uint32_t generation = 0;
+	};
 
-		int speed, numFrames;
-		int currentFrame = 0;
-		bool continous;			
-		float animationDistance;
+	enum class ChannelChange : uint8_t {
+		None,
+		Adjust, // Value is added to the object
+		Set     // Value is the final one of a finished animation
 	};
 
-	AnimationProperty(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMFLOAT3& targetFloat3, bool continous);
-	AnimationProperty(GameObject* targetObject, AnimationType type, int speed, const DirectX::XMVECTOR& targetVector, bool continous);
+	// Channels of an animated object and the change each of them makes in the current update
+	struct AnimatedObject
+	{
+		GameObject* object = nullptr;
+		uint32_t slot[ANIMATION_TYPE_COUNT] = { ANIMATION_NONE, ANIMATION_NONE, ANIMATION_NONE }; // Handle slot on every channel, ANIMATION_NONE if free
+		DirectX::XMFLOAT3 value[ANIMATION_TYPE_COUNT];
+		ChannelChange change[ANIMATION_TYPE_COUNT] = { ChannelChange::None, ChannelChange::None, ChannelChange::None };
+	};
 
-	void Start();
-	void Pause();
-	void Resume();
+	struct EvaluateJob
+	{
+		AnimationSystem* system;
+		float dt;
+	};
 
-	void SetState(AnimationState state);
-	void NextFrame();
+	AnimationHandle Add(GameObject* targetObject, AnimationType type, AnimationProperty& animation);
+	static void EvaluateChunk(void* context, size_t begin, size_t end);
+	static void ApplyChunk(void* context, size_t begin, size_t end);
+	void Run(size_t count, WorkerFunction function, void* context);
+	void HandleEvents();
+	void PushEvent(AnimationEventType type, const AnimationProperty& animation);
 
-	StartValuesStruct StartValues();
-	ParametersStruct Parameter();
+	AnimationProperty* Find(AnimationHandle handle);
+	const AnimationProperty* Find(AnimationHandle handle) const;
+	void Remove(AnimationType type, uint32_t index);
 
-private:
-	void CalculateAnimationDistance();
-	void SetProperties(GameObject* targetObject, AnimationType type, int speed, bool continous);
+	std::vector<AnimationProperty> pools[ANIMATION_TYPE_COUNT];
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
 
-	StartValuesStruct startValue;
+	// Objects stay in here once animated until RemoveAnimation(GameObject*), so animating them again does not allocate
+	std::vector<AnimatedObject> objects;
+	std::unordered_map<const GameObject*, uint32_t> objectIndex;
 
-	AnimationType animationType;
-	ParametersStruct parameter;
-};
\ No newline at end of file
+	WorkerPool* workers = nullptr;
+	std::atomic<uint32_t> eventCount{ 0 }; // Animations that finished or looped during the current update
+	AnimationEventQueue events = AnimationEventQueue(ANIMATION_EVENT_CAPACITY);
+};
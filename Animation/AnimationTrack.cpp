@@ -0,0 +1,147 @@
+#include "AnimationTrack.h"
+#include <algorithm>
+#include <cmath>
+
+static bool TimeBeforeKey(float time, const AnimationKey& key)
+{
+	return time < key.time;
+}
+
+static DirectX::XMFLOAT3 Lerp(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, float t)
+{
+	return DirectX::XMFLOAT3(a.x + ((b.x - a.x) * t), a.y + ((b.y - a.y) * t), a.z + ((b.z - a.z) * t));
+}
+
+static float Bezier(float p0, float p1, float p2, float p3, float t)
+{
+	float u = 1.0f - t;
+	return (u * u * u * p0) + (3.0f * u * u * t * p1) + (3.0f * u * t * t * p2) + (t * t * t * p3);
+}
+
+AnimationTrack::AnimationTrack(TrackWrap wrap)
+{
+	this->wrap = wrap;
+}
+
+// Keys can be added in any order, a key at the same time as an existing one goes after it
+void AnimationTrack::AddKey(float time, const DirectX::XMFLOAT3& value, KeyInterpolation interpolation)
+{
+	AnimationKey key;
+	key.time = time;
+	key.value = value;
+	key.inControl = value;
+	key.outControl = value;
+	key.interpolation = interpolation;
+	InsertKey(key);
+}
+
+void AnimationTrack::AddKey(float time, const DirectX::XMFLOAT3& value, const DirectX::XMFLOAT3& inControl, const DirectX::XMFLOAT3& outControl)
+{
+	AnimationKey key;
+	key.time = time;
+	key.value = value;
+	key.inControl = inControl;
+	key.outControl = outControl;
+	key.interpolation = KeyInterpolation::Bezier;
+	InsertKey(key);
+}
+
+void AnimationTrack::Clear()
+{
+	keys.clear();
+}
+
+/* Turns the time an animation has been playing into time on the track.
+*  Elapsed is kept within one loop (or one forward and back for ping pong) so it never loses precision */
+float AnimationTrack::Wrap(float& elapsed) const
+{
+	float duration = GetDuration();
+	if (duration <= 0.0f)
+		return 0.0f;
+
+	switch (wrap)
+	{
+	case TrackWrap::Loop:
+		elapsed = fmodf(elapsed, duration);
+		return elapsed;
+	case TrackWrap::PingPong:
+		elapsed = fmodf(elapsed, duration * 2.0f);
+		return (elapsed <= duration) ? elapsed : (duration * 2.0f) - elapsed;
+	default:
+		return std::min(elapsed, duration);
+	}
+}
+
+// Value at the time, cursor is the key the animation was at last and is moved to the one the time is at
+DirectX::XMFLOAT3 AnimationTrack::Evaluate(float time, uint32_t& cursor) const
+{
+	if (keys.empty())
+		return DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+	cursor = FindKey(time, cursor);
+	const AnimationKey& key = keys[cursor];
+	if (cursor + 1 >= keys.size() || time <= key.time)
+		return key.value;
+
+	const AnimationKey& next = keys[cursor + 1];
+	float t = (time - key.time) / (next.time - key.time);
+	switch (key.interpolation)
+	{
+	case KeyInterpolation::Step:
+		return key.value;
+	case KeyInterpolation::Bezier:
+		return DirectX::XMFLOAT3(Bezier(key.value.x, key.outControl.x, next.inControl.x, next.value.x, t),
+		                         Bezier(key.value.y, key.outControl.y, next.inControl.y, next.value.y, t),
+		                         Bezier(key.value.z, key.outControl.z, next.inControl.z, next.value.z, t));
+	default:
+		return Lerp(key.value, next.value, t);
+	}
+}
+
+TrackWrap AnimationTrack::GetWrap() const
+{
+	return wrap;
+}
+
+// Time of the last key
+float AnimationTrack::GetDuration() const
+{
+	if (keys.empty())
+		return 0.0f;
+
+	return keys.back().time;
+}
+
+size_t AnimationTrack::GetKeyCount() const
+{
+	return keys.size();
+}
+
+void AnimationTrack::InsertKey(const AnimationKey& key)
+{
+	keys.insert(std::upper_bound(keys.begin(), keys.end(), key.time, TimeBeforeKey), key);
+}
+
+// Index of the last key at or before the time, the first key if the time is before all of them
+uint32_t AnimationTrack::FindKey(float time, uint32_t cursor) const
+{
+	// Playing forwards the time is almost always in the same segment or the one after it
+	uint32_t last = static_cast<uint32_t>(keys.size() - 1);
+	if (cursor <= last && keys[cursor].time <= time)
+	{
+		if (cursor == last || time < keys[cursor + 1].time)
+			return cursor;
+		if (cursor + 1 == last || time < keys[cursor + 2].time)
+			return cursor + 1;
+	}
+
+	// Playing backwards (ping pong) the time is usually in the segment before
+	if (cursor > 0 && cursor <= last && keys[cursor - 1].time <= time && time < keys[cursor].time)
+		return cursor - 1;
+
+	std::vector<AnimationKey>::const_iterator it = std::upper_bound(keys.begin(), keys.end(), time, TimeBeforeKey);
+	if (it == keys.begin())
+		return 0;
+
+	return static_cast<uint32_t>((it - keys.begin()) - 1);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+// How the value moves from a key to the next one
+enum class KeyInterpolation {
+	Linear,
+	Step,  // Keeps the value of the key until the next one
+	Bezier // Cubic Bézier through the out control of the key and the in control of the next one
+};
+
+// What happens once the time passes the last key
+enum class TrackWrap {
+	Once,    // Animation finishes on the last key
+	Loop,    // Starts over from the first key
+	PingPong // Plays backwards to the first key, then forwards again
+};
+
+struct AnimationKey
+{
+	float time = 0.0f; // Miliseconds from the start of the track
+	DirectX::XMFLOAT3 value;
+	DirectX::XMFLOAT3 inControl;  // Bézier control point towards the previous key
+	DirectX::XMFLOAT3 outControl; // Bézier control point towards the next key
+	KeyInterpolation interpolation = KeyInterpolation::Linear;
+};
+
+/* Keys sorted by time that an animation follows instead of a single target.
+*
+*  A track holds no playback state, so one track can drive any number of animations, each with
+*  its own phase. Values are offsets from where the object was when its animation was created.
+*  Every animation keeps the index of the key it was last at and tests that key and the next one
+*  first, the keys are only binary searched when the time jumped further. */
+class AnimationTrack
+{
+public:
+	AnimationTrack(TrackWrap wrap = TrackWrap::Once);
+
+	void AddKey(float time, const DirectX::XMFLOAT3& value, KeyInterpolation interpolation = KeyInterpolation::Linear);
+	void AddKey(float time, const DirectX::XMFLOAT3& value, const DirectX::XMFLOAT3& inControl, const DirectX::XMFLOAT3& outControl);
+	void Clear();
+
+	float Wrap(float& elapsed) const;
+	DirectX::XMFLOAT3 Evaluate(float time, uint32_t& cursor) const;
+
+	TrackWrap GetWrap() const;
+	float GetDuration() const;
+	size_t GetKeyCount() const;
+
+private:
+	void InsertKey(const AnimationKey& key);
+	uint32_t FindKey(float time, uint32_t cursor) const;
+
+	std::vector<AnimationKey> keys;
+	TrackWrap wrap;
+};
@@ -0,0 +1,362 @@
+#include "CookedMesh.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+constexpr size_t HASH_CHUNK_SIZE = 64 * 1024;
+#ifdef _WIN32
+constexpr uint64_t FILETIME_TICKS_PER_SECOND = 10000000;
+constexpr uint64_t FILETIME_UNIX_EPOCH = 11644473600; // Seconds from 1601 to 1970
+#endif
+
+static uint64_t Align(uint64_t offset)
+{
+	return (offset + COOKED_MESH_ALIGNMENT - 1) & ~(COOKED_MESH_ALIGNMENT - 1);
+}
+
+// True if count elements of the size starting at the offset lie within the file
+static bool InFile(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize)
+{
+	return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+static bool InRange(uint64_t first, uint64_t count, uint64_t total)
+{
+	return first <= total && count <= total - first;
+}
+
+static void Copy(std::vector<uint8_t>& buffer, uint64_t offset, const void* data, size_t size)
+{
+	if (size > 0)
+		std::memcpy(buffer.data() + offset, data, size);
+}
+
+// Cooked files sit next to the model file, "Data\Objects\Cheese.fbx" is cooked to "Data\Objects\Cheese.fbx.mesh"
+std::string CookedMesh::GetCookedPath(const std::string& modelPath)
+{
+	return modelPath + ".mesh";
+}
+
+/* Size and last write time of the file in seconds since 1970, without reading the file.
+*  Matching the stamp in a cooked header is enough to trust it, anything else falls back to the hash */
+bool CookedMesh::GetFileStamp(const std::string& filePath, uint64_t& size, uint64_t& time)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(filePath.c_str(), GetFileExInfoStandard, &attributes) || (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return false;
+
+	size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+	uint64_t ticks = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	time = (ticks / FILETIME_TICKS_PER_SECOND) - FILETIME_UNIX_EPOCH;
+#else
+	struct stat status;
+	if (stat(filePath.c_str(), &status) != 0 || !S_ISREG(status.st_mode))
+		return false;
+
+	size = static_cast<uint64_t>(status.st_size);
+	time = static_cast<uint64_t>(status.st_mtime);
+#endif
+	return true;
+}
+
+/* Size and 64 bit FNV-1a hash of the contents of the file.
+*  Decides if a cooked file is stale when its stamp does not match, so cooked files stay valid when copied */
+bool CookedMesh::HashFile(const std::string& filePath, uint64_t& size, uint64_t& hash)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file)
+		return false;
+
+	std::vector<char> chunk(HASH_CHUNK_SIZE);
+	size = 0;
+	hash = FNV_OFFSET_BASIS;
+	while (file)
+	{
+		file.read(chunk.data(), chunk.size());
+		std::streamsize count = file.gcount();
+		for (std::streamsize i = 0; i < count; i++)
+		{
+			hash ^= static_cast<uint8_t>(chunk[i]);
+			hash *= FNV_PRIME;
+		}
+		size += static_cast<uint64_t>(count);
+	}
+	return file.eof();
+}
+
+/* Writes the model to a temporary file first and renames it over the old one,
+*  a game started while cooking never maps a half written file */
+bool CookedMesh::Write(const std::string& filePath, const ModelData& model, uint64_t sourceSize, uint64_t sourceHash, uint64_t sourceTime)
+{
+	CookedMeshHeader header = {};
+	header.magic = COOKED_MESH_MAGIC;
+	header.version = COOKED_MESH_VERSION;
+	header.vertexSize = sizeof(Vertex);
+	header.indexSize = sizeof(uint32_t);
+	header.sourceSize = sourceSize;
+	header.sourceHash = sourceHash;
+	header.sourceTime = sourceTime;
+	header.meshCount = static_cast<uint32_t>(model.meshes.size());
+	header.textureCount = static_cast<uint32_t>(model.textures.size());
+
+	uint64_t vertexCount = 0;
+	uint64_t indexCount = 0;
+	uint64_t meshTextureCount = 0;
+	for (size_t i = 0; i < model.meshes.size(); i++)
+	{
+		vertexCount += model.meshes[i].vertices.size();
+		indexCount += model.meshes[i].indices.size();
+		meshTextureCount += model.meshes[i].textures.size();
+	}
+	if (vertexCount > UINT32_MAX || indexCount > UINT32_MAX)
+		return false;
+	header.vertexCount = static_cast<uint32_t>(vertexCount);
+	header.indexCount = static_cast<uint32_t>(indexCount);
+	header.meshTextureCount = static_cast<uint32_t>(meshTextureCount);
+
+	header.meshOffset = Align(sizeof(CookedMeshHeader));
+	header.textureOffset = Align(header.meshOffset + (header.meshCount * sizeof(CookedMeshEntry)));
+	header.meshTextureOffset = Align(header.textureOffset + (header.textureCount * sizeof(CookedTextureEntry)));
+	header.vertexOffset = Align(header.meshTextureOffset + (meshTextureCount * sizeof(uint32_t)));
+	header.indexOffset = Align(header.vertexOffset + (vertexCount * sizeof(Vertex)));
+	header.blobOffset = Align(header.indexOffset + (indexCount * sizeof(uint32_t)));
+
+	uint64_t blobSize = 0;
+	for (size_t i = 0; i < model.textures.size(); i++)
+		blobSize += model.textures[i].name.size() + model.textures[i].data.size();
+	header.fileSize = header.blobOffset + blobSize;
+
+	std::vector<uint8_t> buffer(static_cast<size_t>(header.fileSize), 0);
+	Copy(buffer, 0, &header, sizeof(header));
+
+	uint32_t firstVertex = 0;
+	uint32_t firstIndex = 0;
+	uint32_t firstTexture = 0;
+	for (size_t i = 0; i < model.meshes.size(); i++)
+	{
+		const MeshData& mesh = model.meshes[i];
+		CookedMeshEntry entry = {};
+		entry.transform = mesh.transform;
+		entry.firstVertex = firstVertex;
+		entry.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+		entry.firstIndex = firstIndex;
+		entry.indexCount = static_cast<uint32_t>(mesh.indices.size());
+		entry.firstTexture = firstTexture;
+		entry.textureCount = static_cast<uint32_t>(mesh.textures.size());
+		Copy(buffer, header.meshOffset + (i * sizeof(CookedMeshEntry)), &entry, sizeof(entry));
+
+		Copy(buffer, header.vertexOffset + (firstVertex * sizeof(Vertex)), mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+		Copy(buffer, header.indexOffset + (firstIndex * sizeof(uint32_t)), mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+		Copy(buffer, header.meshTextureOffset + (firstTexture * sizeof(uint32_t)), mesh.textures.data(), mesh.textures.size() * sizeof(uint32_t));
+		firstVertex += entry.vertexCount;
+		firstIndex += entry.indexCount;
+		firstTexture += entry.textureCount;
+	}
+
+	uint64_t blobOffset = header.blobOffset;
+	for (size_t i = 0; i < model.textures.size(); i++)
+	{
+		const TextureData& texture = model.textures[i];
+		CookedTextureEntry entry = {};
+		entry.type = texture.type;
+		entry.source = static_cast<uint32_t>(texture.source);
+		entry.nameOffset = blobOffset;
+		entry.nameSize = texture.name.size();
+		entry.dataOffset = entry.nameOffset + entry.nameSize;
+		entry.dataSize = texture.data.size();
+		Copy(buffer, header.textureOffset + (i * sizeof(CookedTextureEntry)), &entry, sizeof(entry));
+
+		Copy(buffer, entry.nameOffset, texture.name.data(), texture.name.size());
+		Copy(buffer, entry.dataOffset, texture.data.data(), texture.data.size());
+		blobOffset = entry.dataOffset + entry.dataSize;
+	}
+
+	std::string temporaryPath = filePath + ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+		file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		if (!file)
+		{
+			file.close();
+			std::remove(temporaryPath.c_str());
+			return false;
+		}
+	}
+
+	// Rename does not replace an existing file on Windows
+	std::remove(filePath.c_str());
+	if (std::rename(temporaryPath.c_str(), filePath.c_str()) != 0)
+	{
+		std::remove(temporaryPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+/* Replaces the write time in the header of a cooked file that is not open, for a model file that
+*  was found to have the cooked contents under another time. Checking it again then needs no hash */
+bool CookedMesh::Stamp(const std::string& filePath, uint64_t sourceTime)
+{
+	std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+	if (!file)
+		return false;
+
+	file.seekp(offsetof(CookedMeshHeader, sourceTime));
+	file.write(reinterpret_cast<const char*>(&sourceTime), sizeof(sourceTime));
+	return static_cast<bool>(file);
+}
+
+// Fails for missing files, files from another version of the format and files that are cut off or damaged
+bool CookedMeshFile::Open(const std::string& filePath)
+{
+	Close();
+
+	if (!file.Open(filePath))
+		return false;
+
+	if (file.GetSize() < sizeof(CookedMeshHeader))
+	{
+		Close();
+		return false;
+	}
+
+	header = At<CookedMeshHeader>(0);
+	if (!Validate())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void CookedMeshFile::Close()
+{
+	header = nullptr;
+	file.Close();
+}
+
+bool CookedMeshFile::IsStampedFrom(uint64_t sourceSize, uint64_t sourceTime) const
+{
+	return header != nullptr && header->sourceSize == sourceSize && header->sourceTime == sourceTime;
+}
+
+bool CookedMeshFile::IsCookedFrom(uint64_t sourceSize, uint64_t sourceHash) const
+{
+	return header != nullptr && header->sourceSize == sourceSize && header->sourceHash == sourceHash;
+}
+
+const CookedMeshHeader& CookedMeshFile::GetHeader() const
+{
+	return *header;
+}
+
+const CookedMeshEntry& CookedMeshFile::GetMesh(uint32_t index) const
+{
+	return At<CookedMeshEntry>(header->meshOffset)[index];
+}
+
+const Vertex* CookedMeshFile::GetVertices(const CookedMeshEntry& mesh) const
+{
+	return At<Vertex>(header->vertexOffset) + mesh.firstVertex;
+}
+
+const uint32_t* CookedMeshFile::GetIndices(const CookedMeshEntry& mesh) const
+{
+	return At<uint32_t>(header->indexOffset) + mesh.firstIndex;
+}
+
+const uint32_t* CookedMeshFile::GetMeshTextures(const CookedMeshEntry& mesh) const
+{
+	return At<uint32_t>(header->meshTextureOffset) + mesh.firstTexture;
+}
+
+const CookedTextureEntry& CookedMeshFile::GetTexture(uint32_t index) const
+{
+	return At<CookedTextureEntry>(header->textureOffset)[index];
+}
+
+std::string CookedMeshFile::GetTextureName(const CookedTextureEntry& texture) const
+{
+	return std::string(At<char>(texture.nameOffset), static_cast<size_t>(texture.nameSize));
+}
+
+const uint8_t* CookedMeshFile::GetTextureData(const CookedTextureEntry& texture) const
+{
+	return At<uint8_t>(texture.dataOffset);
+}
+
+bool CookedMeshFile::Validate() const
+{
+	const CookedMeshHeader& h = *header;
+	uint64_t size = file.GetSize();
+
+	if (h.magic != COOKED_MESH_MAGIC || h.version != COOKED_MESH_VERSION ||
+		h.vertexSize != sizeof(Vertex) || h.indexSize != sizeof(uint32_t) || h.fileSize != size)
+		return false;
+
+	// Sections are aligned so the structs in them can be read in place
+	uint64_t offsets[] = { h.meshOffset, h.textureOffset, h.meshTextureOffset, h.vertexOffset, h.indexOffset, h.blobOffset };
+	for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++)
+	{
+		if (offsets[i] % COOKED_MESH_ALIGNMENT != 0 || offsets[i] < sizeof(CookedMeshHeader))
+			return false;
+	}
+
+	if (!InFile(h.meshOffset, h.meshCount, sizeof(CookedMeshEntry), size) ||
+		!InFile(h.textureOffset, h.textureCount, sizeof(CookedTextureEntry), size) ||
+		!InFile(h.meshTextureOffset, h.meshTextureCount, sizeof(uint32_t), size) ||
+		!InFile(h.vertexOffset, h.vertexCount, sizeof(Vertex), size) ||
+		!InFile(h.indexOffset, h.indexCount, sizeof(uint32_t), size) ||
+		h.blobOffset > size)
+		return false;
+
+	for (uint32_t i = 0; i < h.meshCount; i++)
+	{
+		const CookedMeshEntry& mesh = GetMesh(i);
+		if (!InRange(mesh.firstVertex, mesh.vertexCount, h.vertexCount) ||
+			!InRange(mesh.firstIndex, mesh.indexCount, h.indexCount) ||
+			!InRange(mesh.firstTexture, mesh.textureCount, h.meshTextureCount))
+			return false;
+
+		// Indices go to the GPU as they are, one past the vertices of the mesh reads another mesh or past the buffer
+		const uint32_t* indices = GetIndices(mesh);
+		for (uint32_t j = 0; j < mesh.indexCount; j++)
+		{
+			if (indices[j] >= mesh.vertexCount)
+				return false;
+		}
+	}
+
+	const uint32_t* meshTextures = At<uint32_t>(h.meshTextureOffset);
+	for (uint32_t i = 0; i < h.meshTextureCount; i++)
+	{
+		if (meshTextures[i] >= h.textureCount)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < h.textureCount; i++)
+	{
+		const CookedTextureEntry& texture = GetTexture(i);
+		if (texture.source > static_cast<uint32_t>(TextureSource::Disk) ||
+			texture.nameOffset < h.blobOffset || !InFile(texture.nameOffset, texture.nameSize, 1, size) ||
+			texture.dataOffset < h.blobOffset || !InFile(texture.dataOffset, texture.dataSize, 1, size))
+			return false;
+		// Colors are a single RGBA pixel
+		if (texture.source == static_cast<uint32_t>(TextureSource::Color) && texture.dataSize != 4)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.h"
+#include "ModelData.h"
+
+constexpr uint32_t COOKED_MESH_MAGIC = 0x4D443353; // "S3DM"
+constexpr uint32_t COOKED_MESH_VERSION = 4;
+constexpr uint64_t COOKED_MESH_ALIGNMENT = 16;    // Every section starts at a multiple of this
+
+/* Cooked files hold the arrays a Model uploads, in the layout the GPU takes them, so a mapped
+*  file is used in place without parsing. The structs are the file layout (little endian, like
+*  every platform the game runs on). Offsets are from the start of the file.
+*
+*  header | meshes | textures | mesh textures | vertices | indices | names and texture data */
+struct CookedMeshHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vertexSize;       // sizeof(Vertex) when the file was cooked
+	uint32_t indexSize;
+	uint64_t sourceSize;       // Size, FNV-1a hash and last write time (seconds since 1970) of the model file the data was cooked from
+	uint64_t sourceHash;
+	uint64_t sourceTime;
+	uint32_t meshCount;
+	uint32_t textureCount;
+	uint32_t meshTextureCount;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t reserved;
+	uint64_t meshOffset;
+	uint64_t textureOffset;
+	uint64_t meshTextureOffset;
+	uint64_t vertexOffset;
+	uint64_t indexOffset;
+	uint64_t blobOffset;
+	uint64_t fileSize;
+};
+
+struct CookedMeshEntry
+{
+	DirectX::XMFLOAT4X4 transform;
+	uint32_t firstVertex;  // Vertices, indices and textures of the mesh are ranges of the shared arrays
+	uint32_t vertexCount;
+	uint32_t firstIndex;   // Indices start at 0 for the first vertex of the mesh
+	uint32_t indexCount;
+	uint32_t firstTexture; // Into the mesh textures, which hold indices into the textures
+	uint32_t textureCount;
+	uint32_t padding[2];
+};
+
+struct CookedTextureEntry
+{
+	uint32_t type;         // aiTextureType
+	uint32_t source;       // TextureSource
+	uint64_t nameOffset;
+	uint64_t nameSize;
+	uint64_t dataOffset;
+	uint64_t dataSize;
+};
+
+static_assert(sizeof(CookedMeshHeader) == 120, "Cooked mesh header layout changed, bump COOKED_MESH_VERSION");
+static_assert(sizeof(CookedMeshEntry) == 96, "Cooked mesh entry layout changed, bump COOKED_MESH_VERSION");
+static_assert(sizeof(CookedTextureEntry) == 40, "Cooked texture entry layout changed, bump COOKED_MESH_VERSION");
+
+class CookedMesh
+{
+public:
+	static std::string GetCookedPath(const std::string& modelPath);
+	static bool GetFileStamp(const std::string& filePath, uint64_t& size, uint64_t& time);
+	static bool HashFile(const std::string& filePath, uint64_t& size, uint64_t& hash);
+	static bool Write(const std::string& filePath, const ModelData& model, uint64_t sourceSize, uint64_t sourceHash, uint64_t sourceTime);
+	static bool Stamp(const std::string& filePath, uint64_t sourceTime);
+};
+
+/* Cooked file mapped into memory. Open checks every count and offset against the size of the
+*  file, after that the getters hand out pointers into the mapping without further checks. */
+class CookedMeshFile
+{
+public:
+	bool Open(const std::string& filePath);
+	void Close();
+
+	bool IsStampedFrom(uint64_t sourceSize, uint64_t sourceTime) const;
+	bool IsCookedFrom(uint64_t sourceSize, uint64_t sourceHash) const;
+
+	const CookedMeshHeader& GetHeader() const;
+	const CookedMeshEntry& GetMesh(uint32_t index) const;
+	const Vertex* GetVertices(const CookedMeshEntry& mesh) const;
+	const uint32_t* GetIndices(const CookedMeshEntry& mesh) const;
+	const uint32_t* GetMeshTextures(const CookedMeshEntry& mesh) const;
+	const CookedTextureEntry& GetTexture(uint32_t index) const;
+	std::string GetTextureName(const CookedTextureEntry& texture) const;
+	const uint8_t* GetTextureData(const CookedTextureEntry& texture) const;
+
+private:
+	bool Validate() const;
+
+	template<typename T>
+	const T* At(uint64_t offset) const
+	{
+		return reinterpret_cast<const T*>(file.GetData() + offset);
+	}
+
+	MappedFile file;
+	const CookedMeshHeader* header = nullptr;
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* Read only view of a whole file mapped into memory.
+*
+*  Pages are only read from disk when they are touched, so opening a large file costs nothing
+*  until its data is used. The view stays valid until the file is closed. */
+class MappedFile
+{
+public:
+	MappedFile() {}
+	~MappedFile();
+
+	bool Open(const std::string& filePath);
+	void Close();
+
+	bool IsOpen() const;
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+
+private:
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void* file = nullptr;    // HANDLE
+	void* mapping = nullptr; // HANDLE
+#endif
+};
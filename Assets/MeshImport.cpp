@@ -0,0 +1,256 @@
+#include "MeshImport.h"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <cassert>
+#include <cstdlib>
+
+#include "TangentFrames.h"
+#include "../Profiler/Profiler.h"
+
+using namespace DirectX;
+
+static void AddStats(MeshOptimizeStats& total, const MeshOptimizeStats& mesh)
+{
+	uint32_t triangles = total.triangles + mesh.triangles;
+	if (triangles > 0)
+	{
+		// ACMR of the whole model is per triangle, so meshes count by their triangles
+		total.acmrBefore = ((total.acmrBefore * total.triangles) + (mesh.acmrBefore * mesh.triangles)) / triangles;
+		total.acmrAfter = ((total.acmrAfter * total.triangles) + (mesh.acmrAfter * mesh.triangles)) / triangles;
+	}
+	total.sourceVertices += mesh.sourceVertices;
+	total.vertices += mesh.vertices;
+	total.triangles = triangles;
+}
+
+// Same colors as Colors::UnloadedTextureColor and Colors::UnhandledTextureColor
+static const uint8_t UNLOADED_TEXTURE_COLOR[4] = { 100, 100, 100, 255 };
+static const uint8_t UNHANDLED_TEXTURE_COLOR[4] = { 250, 0, 0, 255 };
+
+static void AddColorTexture(ModelData& model, MeshData& mesh, aiTextureType type, const uint8_t* rgba)
+{
+	TextureData texture;
+	texture.type = type;
+	texture.source = TextureSource::Color;
+	texture.data.assign(rgba, rgba + 4);
+	mesh.textures.push_back(static_cast<uint32_t>(model.textures.size()));
+	model.textures.push_back(texture);
+}
+
+static void AddTexture(ModelData& model, MeshData& mesh, aiTextureType type, TextureSource source, const aiString& name, const uint8_t* data, size_t size)
+{
+	TextureData texture;
+	texture.type = type;
+	texture.source = source;
+	texture.name = name.C_Str();
+	texture.data.assign(data, data + size);
+	mesh.textures.push_back(static_cast<uint32_t>(model.textures.size()));
+	model.textures.push_back(texture);
+}
+
+// Index of the texture of the material that is already in the model, -1 if there is none
+static int FindTexture(const ModelData& model, const aiString& name, aiTextureType type)
+{
+	for (size_t i = 0; i < model.textures.size(); i++)
+	{
+		const TextureData& texture = model.textures[i];
+		if (texture.source != TextureSource::Color && texture.type == static_cast<uint32_t>(type) && texture.name == name.C_Str())
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+bool MeshImport::Import(const std::string& filePath, ModelData& model)
+{
+	PROFILE_ZONE("MeshImport::Import");
+
+	Assimp::Importer importer;
+
+	const aiScene* pScene = importer.ReadFile(filePath,
+		aiProcess_Triangulate | aiProcess_ConvertToLeftHanded | aiProcess_GenSmoothNormals);
+
+	if (pScene == nullptr)
+		return false;
+
+	model.meshes.clear();
+	model.textures.clear();
+	model.stats = MeshOptimizeStats();
+	ProcessNode(pScene->mRootNode, pScene, DirectX::XMMatrixIdentity(), model);
+	return true;
+}
+
+void MeshImport::ProcessNode(aiNode* node, const aiScene* scene, const XMMATRIX& parentTransformMatrix, ModelData& model)
+{
+	XMMATRIX nodeTransformMatrix = XMMatrixTranspose(XMMATRIX(&node->mTransformation.a1)) * parentTransformMatrix;
+
+	for (unsigned int i = 0; i < node->mNumMeshes; i++)
+	{
+		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+		model.meshes.push_back(ProcessMesh(mesh, scene, nodeTransformMatrix, model));
+	}
+
+	for (unsigned int i = 0; i < node->mNumChildren; i++)
+	{
+		ProcessNode(node->mChildren[i], scene, nodeTransformMatrix, model);
+	}
+}
+
+MeshData MeshImport::ProcessMesh(aiMesh* mesh, const aiScene* scene, const XMMATRIX& transformMatrix, ModelData& model)
+{
+	// Data to fill
+	MeshData meshData;
+	std::vector<Vertex>& vertices = meshData.vertices;
+	std::vector<uint32_t>& indices = meshData.indices;
+	XMStoreFloat4x4(&meshData.transform, transformMatrix);
+
+	//Get vertices
+	vertices.resize(mesh->mNumVertices);
+	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+	{
+		Vertex& vertex = vertices[i];
+		vertex.pos = XMFLOAT3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+		vertex.normal = XMFLOAT3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+		if (mesh->mTextureCoords[0])
+			vertex.texCoord = XMFLOAT2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+		else
+			vertex.texCoord = XMFLOAT2(0.0f, 0.0f);
+	}
+
+	//Get indices, points and lines are left out
+	indices.reserve(mesh->mNumFaces * 3);
+	for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+	{
+		const aiFace& face = mesh->mFaces[i];
+		if (face.mNumIndices != 3)
+			continue;
+
+		for (unsigned int j = 0; j < face.mNumIndices; j++)
+			indices.push_back(face.mIndices[j]);
+	}
+
+	// Assimp gives every corner of every face its own vertex, welding shares them again
+	AddStats(model.stats, MeshOptimizer::Optimize(vertices, indices));
+	TangentFrames::Generate(vertices.data(), vertices.size(), indices.data(), indices.size());
+
+	// Textures of the material, in the order the mesh looks them up
+	aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+	LoadMaterialTextures(material, aiTextureType::aiTextureType_DIFFUSE, scene, model, meshData);
+	LoadMaterialTextures(material, aiTextureType::aiTextureType_NORMALS, scene, model, meshData);
+	LoadMaterialTextures(material, aiTextureType::aiTextureType_SHININESS, scene, model, meshData);
+
+	return meshData;
+}
+
+TextureStorageType MeshImport::DetermineTextureStorageType(const aiScene* pScene, aiMaterial* pMat, unsigned int index, aiTextureType textureType)
+{
+	if (pMat->GetTextureCount(textureType) == 0)
+		return TextureStorageType::None;
+
+	aiString path;
+	pMat->GetTexture(textureType, index, &path);
+	std::string texturePath = path.C_Str();
+	//Check if texture is an embedded indexed texture by seeing if the file path is an index #
+	if (texturePath[0] == '*')
+	{
+		if (pScene->mTextures[0]->mHeight == 0)
+		{
+			return TextureStorageType::EmbeddedIndexCompressed;
+		}
+		else
+		{
+			assert("SUPPORT DOES NOT EXIST YET FOR INDEXED NON COMPRESSED TEXTURES!" && 0);
+			return TextureStorageType::EmbeddedIndexNonCompressed;
+		}
+	}
+	//Check if texture is an embedded texture but not indexed (path will be the texture's name instead of #)
+	if (auto pTex = pScene->GetEmbeddedTexture(texturePath.c_str()))
+	{
+		if (pTex->mHeight == 0)
+		{
+			return TextureStorageType::EmbeddedCompressed;
+		}
+		else
+		{
+			assert("SUPPORT DOES NOT EXIST YET FOR EMBEDDED NON COMPRESSED TEXTURES!" && 0);
+			return TextureStorageType::EmbeddedNonCompressed;
+		}
+	}
+	//Lastly check if texture is a filepath by checking for period before extension name
+	if (texturePath.find('.') != std::string::npos)
+	{
+		return TextureStorageType::Disk;
+	}
+
+	return TextureStorageType::None; // No texture exists
+}
+
+/* Adds the textures of one type of the material to the mesh.
+*  A material without a diffuse texture gets its diffuse color, any other missing texture the unhandled color */
+void MeshImport::LoadMaterialTextures(aiMaterial* pMaterial, aiTextureType textureType, const aiScene* pScene, ModelData& model, MeshData& mesh)
+{
+	size_t textureStart = mesh.textures.size();
+	unsigned int textureCount = pMaterial->GetTextureCount(textureType);
+
+	if (textureCount == 0 && textureType == aiTextureType_DIFFUSE)
+	{
+		aiColor3D aiColor(0.0f, 0.0f, 0.0f);
+		pMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColor);
+		if (aiColor.IsBlack()) //If color = black, just use grey
+		{
+			AddColorTexture(model, mesh, textureType, UNLOADED_TEXTURE_COLOR);
+			return;
+		}
+		uint8_t color[4] = { static_cast<uint8_t>(aiColor.r * 255), static_cast<uint8_t>(aiColor.g * 255), static_cast<uint8_t>(aiColor.b * 255), 255 };
+		AddColorTexture(model, mesh, textureType, color);
+		return;
+	}
+
+	for (unsigned int i = 0; i < textureCount; i++)
+	{
+		// A texture of the material that another mesh already uses is shared
+		int existing = FindTexture(model, pMaterial->GetName(), textureType);
+		if (existing >= 0)
+		{
+			mesh.textures.push_back(static_cast<uint32_t>(existing));
+			break;
+		}
+
+		aiString path;
+		pMaterial->GetTexture(textureType, i, &path);
+		TextureStorageType storetype = DetermineTextureStorageType(pScene, pMaterial, i, textureType);
+		switch (storetype)
+		{
+		case TextureStorageType::EmbeddedIndexCompressed:
+		{
+			const aiTexture* pTexture = pScene->mTextures[GetTextureIndex(&path)];
+			AddTexture(model, mesh, textureType, TextureSource::Embedded, pMaterial->GetName(), reinterpret_cast<const uint8_t*>(pTexture->pcData), pTexture->mWidth);
+			break;
+		}
+		case TextureStorageType::EmbeddedCompressed: // This is the texture in FBX files from blender
+		{
+			const aiTexture* pTexture = pScene->GetEmbeddedTexture(path.C_Str());
+			AddTexture(model, mesh, textureType, TextureSource::Embedded, pMaterial->GetName(), reinterpret_cast<const uint8_t*>(pTexture->pcData), pTexture->mWidth);
+			break;
+		}
+		case TextureStorageType::Disk:
+		{
+			const uint8_t* filename = reinterpret_cast<const uint8_t*>(path.C_Str());
+			AddTexture(model, mesh, textureType, TextureSource::Disk, pMaterial->GetName(), filename, path.length);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	if (mesh.textures.size() == textureStart)
+	{
+		AddColorTexture(model, mesh, aiTextureType::aiTextureType_DIFFUSE, UNHANDLED_TEXTURE_COLOR);
+	}
+}
+
+int MeshImport::GetTextureIndex(aiString* pStr)
+{
+	assert(pStr->length >= 2);
+	return atoi(&pStr->C_Str()[1]);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <assimp/scene.h>
+
+#include "ModelData.h"
+
+enum class TextureStorageType
+{
+	Invalid,
+	None,
+	EmbeddedIndexCompressed,
+	EmbeddedIndexNonCompressed,
+	EmbeddedCompressed,
+	EmbeddedNonCompressed,
+	Disk
+};
+
+/* Reads a model file (FBX, OBJ) with assimp into ModelData.
+*
+*  Vertices are welded and ordered by the MeshOptimizer, then TangentFrames gives them their
+*  tangent and binormal. Textures keep the material name they belong to, a texture used by
+*  several meshes is stored once. */
+class MeshImport
+{
+public:
+	static bool Import(const std::string& filePath, ModelData& model);
+
+private:
+	static void ProcessNode(aiNode* node, const aiScene* scene, const DirectX::XMMATRIX& parentTransformMatrix, ModelData& model);
+	static MeshData ProcessMesh(aiMesh* mesh, const aiScene* scene, const DirectX::XMMATRIX& transformMatrix, ModelData& model);
+	static TextureStorageType DetermineTextureStorageType(const aiScene* pScene, aiMaterial* pMat, unsigned int index, aiTextureType textureType);
+	static void LoadMaterialTextures(aiMaterial* pMaterial, aiTextureType textureType, const aiScene* pScene, ModelData& model, MeshData& mesh);
+	static int GetTextureIndex(aiString* pStr);
+};
@@ -0,0 +1,304 @@
+#include "MeshOptimizer.h"
+#include <cmath>
+#include <cstring>
+
+#include "../Profiler/Profiler.h"
+
+// Scoring from the paper, tuned for caches of 16 to 64 entries
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+constexpr uint32_t MAX_SCORED_VALENCE = 32; // Vertices with more triangles left score like this many
+constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+// Only what the vertex looked like in the model file, tangent frames are built after welding
+static bool SameVertex(const Vertex& a, const Vertex& b)
+{
+	return std::memcmp(&a.pos, &b.pos, sizeof(a.pos)) == 0 &&
+	       std::memcmp(&a.texCoord, &b.texCoord, sizeof(a.texCoord)) == 0 &&
+	       std::memcmp(&a.normal, &b.normal, sizeof(a.normal)) == 0;
+}
+
+static uint32_t HashVertex(const Vertex& vertex)
+{
+	float values[8] = { vertex.pos.x, vertex.pos.y, vertex.pos.z, vertex.texCoord.x, vertex.texCoord.y, vertex.normal.x, vertex.normal.y, vertex.normal.z };
+	uint32_t hash = 2166136261u;
+	for (int i = 0; i < 8; i++)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &values[i], sizeof(bits));
+		hash = (hash ^ bits) * 16777619u;
+		hash ^= hash >> 15;
+	}
+	return hash;
+}
+
+struct VertexScores
+{
+	float cache[VERTEX_CACHE_SIZE];
+	float valence[MAX_SCORED_VALENCE + 1];
+
+	VertexScores()
+	{
+		for (uint32_t i = 0; i < VERTEX_CACHE_SIZE; i++)
+		{
+			// The vertices of the last triangle get a fixed score so the next triangle does not just reuse two of them
+			if (i < 3)
+				cache[i] = LAST_TRIANGLE_SCORE;
+			else
+				cache[i] = powf(1.0f - ((i - 3) * (1.0f / (VERTEX_CACHE_SIZE - 3))), CACHE_DECAY_POWER);
+		}
+
+		valence[0] = 0.0f;
+		for (uint32_t i = 1; i <= MAX_SCORED_VALENCE; i++)
+			valence[i] = VALENCE_BOOST_SCALE * powf(static_cast<float>(i), -VALENCE_BOOST_POWER);
+	}
+
+	// Vertices with few triangles left are boosted so they get finished instead of left behind
+	float Get(uint32_t cachePosition, uint32_t remainingTriangles) const
+	{
+		if (remainingTriangles == 0)
+			return -1.0f;
+
+		float score = (cachePosition < VERTEX_CACHE_SIZE) ? cache[cachePosition] : 0.0f;
+		return score + valence[(remainingTriangles < MAX_SCORED_VALENCE) ? remainingTriangles : MAX_SCORED_VALENCE];
+	}
+};
+
+MeshOptimizeStats MeshOptimizer::Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	PROFILE_ZONE("MeshOptimizer::Optimize");
+
+	MeshOptimizeStats stats;
+	stats.sourceVertices = static_cast<uint32_t>(vertices.size());
+
+	Weld(vertices, indices);
+	stats.acmrBefore = CalculateACMR(indices, vertices.size());
+
+	OptimizeVertexCache(indices, vertices.size());
+	OptimizeVertexFetch(vertices, indices);
+	stats.acmrAfter = CalculateACMR(indices, vertices.size());
+
+	stats.vertices = static_cast<uint32_t>(vertices.size());
+	stats.triangles = static_cast<uint32_t>(indices.size() / 3);
+	return stats;
+}
+
+/* Keeps the first of every set of identical vertices and points the indices at it.
+*  Triangles that use the same vertex twice draw nothing and are dropped */
+void MeshOptimizer::Weld(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	size_t tableSize = 16;
+	while (tableSize < vertices.size() * 2)
+		tableSize *= 2;
+
+	std::vector<uint32_t> table(tableSize, INVALID_INDEX); // Open addressing, holds indices into the welded vertices
+	std::vector<uint32_t> remap(vertices.size());
+	std::vector<Vertex> welded;
+	welded.reserve(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		size_t slot = HashVertex(vertices[i]) & (tableSize - 1);
+		while (table[slot] != INVALID_INDEX && !SameVertex(welded[table[slot]], vertices[i]))
+			slot = (slot + 1) & (tableSize - 1);
+
+		if (table[slot] == INVALID_INDEX)
+		{
+			table[slot] = static_cast<uint32_t>(welded.size());
+			welded.push_back(vertices[i]);
+		}
+		remap[i] = table[slot];
+	}
+
+	size_t count = 0;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t a = remap[indices[i]];
+		uint32_t b = remap[indices[i + 1]];
+		uint32_t c = remap[indices[i + 2]];
+		if (a == b || b == c || c == a)
+			continue;
+
+		indices[count++] = a;
+		indices[count++] = b;
+		indices[count++] = c;
+	}
+	indices.resize(count);
+	vertices.swap(welded);
+}
+
+// Reorders the triangles so vertices are reused while they are still in the cache
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	static const VertexScores scores;
+
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Triangles of every vertex, the first remaining[v] of them are not drawn yet
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		remaining[indices[i]]++;
+
+	std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+		firstTriangle[v + 1] = firstTriangle[v] + remaining[v];
+
+	std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+	std::vector<uint32_t> filled(vertexCount, 0);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t v = indices[(t * 3) + k];
+			vertexTriangles[firstTriangle[v] + filled[v]++] = static_cast<uint32_t>(t);
+		}
+	}
+
+	std::vector<uint32_t> cachePosition(vertexCount, VERTEX_CACHE_SIZE);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		vertexScore[v] = scores.Get(VERTEX_CACHE_SIZE, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> drawn(triangleCount, false);
+	uint32_t best = 0;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[(t * 3) + 1]] + vertexScore[indices[(t * 3) + 2]];
+		if (triangleScore[t] > triangleScore[best])
+			best = static_cast<uint32_t>(t);
+	}
+
+	std::vector<uint32_t> ordered;
+	ordered.reserve(triangleCount * 3);
+	uint32_t cache[VERTEX_CACHE_SIZE + 3];
+	uint32_t cacheSize = 0;
+	size_t cursor = 0; // Triangles before it are all drawn
+
+	while (ordered.size() < triangleCount * 3)
+	{
+		const uint32_t* triangle = &indices[best * 3];
+		drawn[best] = true;
+
+		// Drawn triangles are swapped behind the remaining ones of their vertices
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t v = triangle[k];
+			ordered.push_back(v);
+
+			uint32_t* list = &vertexTriangles[firstTriangle[v]];
+			for (uint32_t i = 0; i < remaining[v]; i++)
+			{
+				if (list[i] == best)
+				{
+					list[i] = list[remaining[v] - 1];
+					list[remaining[v] - 1] = best;
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// The vertices of the triangle move to the front of the cache, the rest shift back
+		uint32_t newCache[VERTEX_CACHE_SIZE + 3];
+		uint32_t newSize = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			if (newSize == 0 || (newCache[0] != triangle[k] && (newSize < 2 || newCache[1] != triangle[k])))
+				newCache[newSize++] = triangle[k];
+		}
+		for (uint32_t i = 0; i < cacheSize; i++)
+		{
+			uint32_t v = cache[i];
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+				newCache[newSize++] = v;
+		}
+
+		// Vertices pushed out of the cache lose their cache score too
+		for (uint32_t i = 0; i < newSize; i++)
+			cachePosition[newCache[i]] = (i < VERTEX_CACHE_SIZE) ? i : VERTEX_CACHE_SIZE;
+
+		float bestScore = -1.0f;
+		best = INVALID_INDEX;
+		for (uint32_t i = 0; i < newSize; i++)
+		{
+			uint32_t v = newCache[i];
+			float score = scores.Get(cachePosition[v], remaining[v]);
+			float change = score - vertexScore[v];
+			vertexScore[v] = score;
+
+			const uint32_t* list = &vertexTriangles[firstTriangle[v]];
+			for (uint32_t j = 0; j < remaining[v]; j++)
+			{
+				uint32_t t = list[j];
+				triangleScore[t] += change;
+				if (triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					best = t;
+				}
+			}
+		}
+
+		cacheSize = (newSize < VERTEX_CACHE_SIZE) ? newSize : VERTEX_CACHE_SIZE;
+		std::memcpy(cache, newCache, cacheSize * sizeof(uint32_t));
+
+		// Nothing left around the cache, carry on with the next triangle that is not drawn yet
+		if (best == INVALID_INDEX)
+		{
+			while (cursor < triangleCount && drawn[cursor])
+				cursor++;
+			if (cursor == triangleCount)
+				break;
+			best = static_cast<uint32_t>(cursor);
+		}
+	}
+
+	std::memcpy(indices.data(), ordered.data(), ordered.size() * sizeof(uint32_t));
+}
+
+// Puts the vertices in the order the indices first use them, vertices no triangle uses are dropped
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+	std::vector<Vertex> ordered;
+	ordered.reserve(vertices.size());
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		uint32_t& index = indices[i];
+		if (remap[index] == INVALID_INDEX)
+		{
+			remap[index] = static_cast<uint32_t>(ordered.size());
+			ordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.swap(ordered);
+}
+
+// Vertex shader runs per triangle with a FIFO cache of the size, the way most GPUs reuse vertices
+float MeshOptimizer::CalculateACMR(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return 0.0f;
+
+	// A vertex is in the cache while fewer than cacheSize misses happened since it was loaded
+	std::vector<uint32_t> loadedAt(vertexCount, INVALID_INDEX);
+	uint32_t misses = 0;
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		uint32_t v = indices[i];
+		if (loadedAt[v] == INVALID_INDEX || misses - loadedAt[v] >= cacheSize)
+		{
+			loadedAt[v] = misses;
+			misses++;
+		}
+	}
+	return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "../Graphics/Vertex.h"
+
+// Where the pixels of a texture come from
+enum class TextureSource : uint32_t
+{
+	Color,    // Data is one RGBA pixel
+	Embedded, // Data is a compressed image (png, jpg) stored in the model file
+	Disk      // Data is the path of an image file, relative to the model file
+};
+
+struct TextureData
+{
+	uint32_t type = 0;    // aiTextureType, which shader slot the texture is bound to
+	TextureSource source = TextureSource::Color;
+	std::string name;     // Material name, textures with the same name and type are only created once
+	std::vector<uint8_t> data;
+};
+
+struct MeshData
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<uint32_t> textures; // Indices into the textures of the model
+	DirectX::XMFLOAT4X4 transform;  // Node transform, including the transforms of the parent nodes
+};
+
+// Everything needed to build a Model, without any GPU objects
+struct ModelData
+{
+	std::vector<MeshData> meshes;
+	std::vector<TextureData> textures;
+	MeshOptimizeStats stats; // Summed over the meshes when importing, not cooked
+};
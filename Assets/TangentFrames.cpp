@@ -0,0 +1,253 @@
+#include "TangentFrames.h"
+#include <algorithm>
+#include <vector>
+
+#include "../Profiler/Profiler.h"
+
+using namespace DirectX;
+
+// Tangent and binormal directions summed over the triangles of a vertex
+struct FrameSum
+{
+	float tangent[3];
+	float binormal[3];
+};
+
+// Position and texture coordinate of four vertices, one vertex in every lane
+struct CornerLanes
+{
+	XMVECTOR x, y, z;
+	XMVECTOR u, v;
+};
+
+// Three component vectors of four vertices, one vertex in every lane
+struct VectorLanes
+{
+	XMVECTOR x, y, z;
+};
+
+static CornerLanes GatherCorners(const Vertex* const corners[4])
+{
+	CornerLanes lanes;
+	lanes.x = XMVectorSet(corners[0]->pos.x, corners[1]->pos.x, corners[2]->pos.x, corners[3]->pos.x);
+	lanes.y = XMVectorSet(corners[0]->pos.y, corners[1]->pos.y, corners[2]->pos.y, corners[3]->pos.y);
+	lanes.z = XMVectorSet(corners[0]->pos.z, corners[1]->pos.z, corners[2]->pos.z, corners[3]->pos.z);
+	lanes.u = XMVectorSet(corners[0]->texCoord.x, corners[1]->texCoord.x, corners[2]->texCoord.x, corners[3]->texCoord.x);
+	lanes.v = XMVectorSet(corners[0]->texCoord.y, corners[1]->texCoord.y, corners[2]->texCoord.y, corners[3]->texCoord.y);
+	return lanes;
+}
+
+static XMVECTOR Dot(const VectorLanes& a, const VectorLanes& b)
+{
+	return XMVectorMultiplyAdd(a.x, b.x, XMVectorMultiplyAdd(a.y, b.y, XMVectorMultiply(a.z, b.z)));
+}
+
+static VectorLanes Cross(const VectorLanes& a, const VectorLanes& b)
+{
+	VectorLanes result;
+	result.x = XMVectorNegativeMultiplySubtract(a.z, b.y, XMVectorMultiply(a.y, b.z));
+	result.y = XMVectorNegativeMultiplySubtract(a.x, b.z, XMVectorMultiply(a.z, b.x));
+	result.z = XMVectorNegativeMultiplySubtract(a.y, b.x, XMVectorMultiply(a.x, b.y));
+	return result;
+}
+
+static VectorLanes Scale(const VectorLanes& a, XMVECTOR s)
+{
+	VectorLanes result;
+	result.x = XMVectorMultiply(a.x, s);
+	result.y = XMVectorMultiply(a.y, s);
+	result.z = XMVectorMultiply(a.z, s);
+	return result;
+}
+
+static VectorLanes Select(const VectorLanes& a, const VectorLanes& b, XMVECTOR control)
+{
+	VectorLanes result;
+	result.x = XMVectorSelect(a.x, b.x, control);
+	result.y = XMVectorSelect(a.y, b.y, control);
+	result.z = XMVectorSelect(a.z, b.z, control);
+	return result;
+}
+
+// Unit length, only meant for lanes that have a length
+static VectorLanes Normalize(const VectorLanes& a)
+{
+	return Scale(a, XMVectorReciprocalSqrt(Dot(a, a)));
+}
+
+// Lanes that are neither NaN nor infinite
+static XMVECTOR IsFinite(XMVECTOR v)
+{
+	return XMVectorAndCInt(XMVectorTrueInt(), XMVectorOrInt(XMVectorIsNaN(v), XMVectorIsInfinite(v)));
+}
+
+/* Adds the texture space directions of the triangles first to first + 3 to their vertices.
+*  Missing or broken triangles are read from a zero vertex, their UVs are in a line and they add nothing */
+static void AccumulateTriangles(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t first, size_t count, FrameSum* sums)
+{
+	static const Vertex ZERO_VERTEX(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+
+	uint32_t triangleIndices[4][3] = {};
+	const Vertex* corners[3][4];
+	for (size_t lane = 0; lane < 4; lane++)
+	{
+		corners[0][lane] = corners[1][lane] = corners[2][lane] = &ZERO_VERTEX;
+		if (lane >= count)
+			continue;
+
+		const uint32_t* triangle = indices + ((first + lane) * 3);
+		if (triangle[0] >= vertexCount || triangle[1] >= vertexCount || triangle[2] >= vertexCount)
+			continue;
+
+		for (size_t k = 0; k < 3; k++)
+		{
+			triangleIndices[lane][k] = triangle[k];
+			corners[k][lane] = &vertices[triangle[k]];
+		}
+	}
+
+	CornerLanes c0 = GatherCorners(corners[0]);
+	CornerLanes c1 = GatherCorners(corners[1]);
+	CornerLanes c2 = GatherCorners(corners[2]);
+
+	VectorLanes edge1 = { XMVectorSubtract(c1.x, c0.x), XMVectorSubtract(c1.y, c0.y), XMVectorSubtract(c1.z, c0.z) };
+	VectorLanes edge2 = { XMVectorSubtract(c2.x, c0.x), XMVectorSubtract(c2.y, c0.y), XMVectorSubtract(c2.z, c0.z) };
+	XMVECTOR du1 = XMVectorSubtract(c1.u, c0.u);
+	XMVECTOR dv1 = XMVectorSubtract(c1.v, c0.v);
+	XMVECTOR du2 = XMVectorSubtract(c2.u, c0.u);
+	XMVECTOR dv2 = XMVectorSubtract(c2.v, c0.v);
+
+	// The tangent runs along the edge where v stays the same, the binormal along the one where u does
+	VectorLanes tangent = {
+		XMVectorNegativeMultiplySubtract(dv1, edge2.x, XMVectorMultiply(dv2, edge1.x)),
+		XMVectorNegativeMultiplySubtract(dv1, edge2.y, XMVectorMultiply(dv2, edge1.y)),
+		XMVectorNegativeMultiplySubtract(dv1, edge2.z, XMVectorMultiply(dv2, edge1.z)) };
+	VectorLanes binormal = {
+		XMVectorNegativeMultiplySubtract(du2, edge1.x, XMVectorMultiply(du1, edge2.x)),
+		XMVectorNegativeMultiplySubtract(du2, edge1.y, XMVectorMultiply(du1, edge2.y)),
+		XMVectorNegativeMultiplySubtract(du2, edge1.z, XMVectorMultiply(du1, edge2.z)) };
+
+	// Dividing by the determinant would only scale them, its sign says which way they point
+	XMVECTOR determinant = XMVectorNegativeMultiplySubtract(du2, dv1, XMVectorMultiply(du1, dv2));
+	XMVECTOR sign = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(determinant, XMVectorZero()));
+	tangent = Scale(tangent, sign);
+	binormal = Scale(binormal, sign);
+
+	// Compared with the UV edge lengths, so the test does not depend on how large the texture is
+	XMVECTOR uvLength = XMVectorMultiplyAdd(du1, du1, XMVectorMultiplyAdd(dv1, dv1, XMVectorMultiplyAdd(du2, du2, XMVectorMultiply(dv2, dv2))));
+	XMVECTOR hasTextureSpace = XMVectorGreater(XMVectorAbs(determinant), XMVectorMultiply(uvLength, XMVectorReplicate(TEXTURE_SPACE_EPSILON)));
+	XMVECTOR total = XMVectorAdd(XMVectorAdd(XMVectorAdd(tangent.x, tangent.y), XMVectorAdd(tangent.z, binormal.x)), XMVectorAdd(binormal.y, binormal.z));
+	XMVECTOR valid = XMVectorAndInt(hasTextureSpace, IsFinite(total));
+
+	VectorLanes zero = { XMVectorZero(), XMVectorZero(), XMVectorZero() };
+	tangent = Select(zero, tangent, valid);
+	binormal = Select(zero, binormal, valid);
+
+	XMFLOAT4A tangentX, tangentY, tangentZ, binormalX, binormalY, binormalZ;
+	XMStoreFloat4A(&tangentX, tangent.x);
+	XMStoreFloat4A(&tangentY, tangent.y);
+	XMStoreFloat4A(&tangentZ, tangent.z);
+	XMStoreFloat4A(&binormalX, binormal.x);
+	XMStoreFloat4A(&binormalY, binormal.y);
+	XMStoreFloat4A(&binormalZ, binormal.z);
+
+	// Vertices are shared between triangles, so the sums are added one lane after the other
+	const float* lanes[6] = { &tangentX.x, &tangentY.x, &tangentZ.x, &binormalX.x, &binormalY.x, &binormalZ.x };
+	for (size_t lane = 0; lane < count; lane++)
+	{
+		for (size_t k = 0; k < 3; k++)
+		{
+			FrameSum& sum = sums[triangleIndices[lane][k]];
+			sum.tangent[0] += lanes[0][lane];
+			sum.tangent[1] += lanes[1][lane];
+			sum.tangent[2] += lanes[2][lane];
+			sum.binormal[0] += lanes[3][lane];
+			sum.binormal[1] += lanes[4][lane];
+			sum.binormal[2] += lanes[5][lane];
+		}
+	}
+}
+
+// Orthonormal frames for the vertices first to first + 3, lanes past the last vertex repeat it
+static void FinishVertices(Vertex* vertices, const FrameSum* sums, size_t first, size_t count)
+{
+	size_t index[4];
+	for (size_t lane = 0; lane < 4; lane++)
+		index[lane] = first + std::min(lane, count - 1);
+
+	const Vertex* v[4] = { &vertices[index[0]], &vertices[index[1]], &vertices[index[2]], &vertices[index[3]] };
+	const FrameSum* s[4] = { &sums[index[0]], &sums[index[1]], &sums[index[2]], &sums[index[3]] };
+	VectorLanes normal = {
+		XMVectorSet(v[0]->normal.x, v[1]->normal.x, v[2]->normal.x, v[3]->normal.x),
+		XMVectorSet(v[0]->normal.y, v[1]->normal.y, v[2]->normal.y, v[3]->normal.y),
+		XMVectorSet(v[0]->normal.z, v[1]->normal.z, v[2]->normal.z, v[3]->normal.z) };
+	VectorLanes tangentSum = {
+		XMVectorSet(s[0]->tangent[0], s[1]->tangent[0], s[2]->tangent[0], s[3]->tangent[0]),
+		XMVectorSet(s[0]->tangent[1], s[1]->tangent[1], s[2]->tangent[1], s[3]->tangent[1]),
+		XMVectorSet(s[0]->tangent[2], s[1]->tangent[2], s[2]->tangent[2], s[3]->tangent[2]) };
+	VectorLanes binormalSum = {
+		XMVectorSet(s[0]->binormal[0], s[1]->binormal[0], s[2]->binormal[0], s[3]->binormal[0]),
+		XMVectorSet(s[0]->binormal[1], s[1]->binormal[1], s[2]->binormal[1], s[3]->binormal[1]),
+		XMVectorSet(s[0]->binormal[2], s[1]->binormal[2], s[2]->binormal[2], s[3]->binormal[2]) };
+
+	// A normal without a length (or not finite) points up
+	XMVECTOR normalLength = Dot(normal, normal);
+	VectorLanes up = { XMVectorZero(), g_XMOne, XMVectorZero() };
+	normal = Select(up, Normalize(normal), XMVectorAndInt(XMVectorGreater(normalLength, XMVectorReplicate(1e-24f)), IsFinite(normalLength)));
+
+	// Gram-Schmidt, the tangent needs some length left once the part along the normal is taken out
+	XMVECTOR along = Dot(normal, tangentSum);
+	VectorLanes perpendicular;
+	perpendicular.x = XMVectorNegativeMultiplySubtract(normal.x, along, tangentSum.x);
+	perpendicular.y = XMVectorNegativeMultiplySubtract(normal.y, along, tangentSum.y);
+	perpendicular.z = XMVectorNegativeMultiplySubtract(normal.z, along, tangentSum.z);
+	XMVECTOR perpendicularLength = Dot(perpendicular, perpendicular);
+	XMVECTOR hasTangent = XMVectorGreater(perpendicularLength, XMVectorMultiply(Dot(tangentSum, tangentSum), XMVectorReplicate(1e-8f)));
+
+	// Cross with the axis furthest from the normal, X unless the normal is close to it
+	VectorLanes crossX = { XMVectorZero(), XMVectorNegate(normal.z), normal.y };
+	VectorLanes crossY = { normal.z, XMVectorZero(), XMVectorNegate(normal.x) };
+	VectorLanes fallback = Select(crossY, crossX, XMVectorLess(XMVectorAbs(normal.x), XMVectorReplicate(0.9f)));
+	VectorLanes tangent = Normalize(Select(fallback, perpendicular, hasTangent));
+
+	VectorLanes binormal = Cross(normal, tangent);
+	XMVECTOR sign = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(Dot(binormal, binormalSum), XMVectorZero()));
+	binormal = Scale(binormal, sign);
+
+	XMFLOAT4A frame[9];
+	XMStoreFloat4A(&frame[0], normal.x);
+	XMStoreFloat4A(&frame[1], normal.y);
+	XMStoreFloat4A(&frame[2], normal.z);
+	XMStoreFloat4A(&frame[3], tangent.x);
+	XMStoreFloat4A(&frame[4], tangent.y);
+	XMStoreFloat4A(&frame[5], tangent.z);
+	XMStoreFloat4A(&frame[6], binormal.x);
+	XMStoreFloat4A(&frame[7], binormal.y);
+	XMStoreFloat4A(&frame[8], binormal.z);
+
+	const float* f[9];
+	for (size_t i = 0; i < 9; i++)
+		f[i] = &frame[i].x;
+
+	for (size_t lane = 0; lane < count; lane++)
+	{
+		Vertex& vertex = vertices[first + lane];
+		vertex.normal = XMFLOAT3(f[0][lane], f[1][lane], f[2][lane]);
+		vertex.tangent = XMFLOAT3(f[3][lane], f[4][lane], f[5][lane]);
+		vertex.biNormal = XMFLOAT3(f[6][lane], f[7][lane], f[8][lane]);
+	}
+}
+
+// Triangles with an index past the vertices are left out
+void TangentFrames::Generate(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+{
+	PROFILE_ZONE("TangentFrames::Generate");
+
+	std::vector<FrameSum> sums(vertexCount, FrameSum());
+	size_t triangleCount = indexCount / 3;
+	for (size_t first = 0; first < triangleCount; first += 4)
+		AccumulateTriangles(vertices, vertexCount, indices, first, std::min<size_t>(4, triangleCount - first), sums.data());
+
+	for (size_t first = 0; first < vertexCount; first += 4)
+		FinishVertices(vertices, sums.data(), first, std::min<size_t>(4, vertexCount - first));
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "../Graphics/Vertex.h"
+
+constexpr float TEXTURE_SPACE_EPSILON = 1e-5f; // Triangles whose UVs are closer to a line than this add no tangent
+
+/* Gives every vertex of an indexed triangle list a tangent and binormal for normal mapping.
+*
+*  Triangles are handled four at a time, one in every lane of an XMVECTOR. Every triangle adds the
+*  directions the texture coordinates run along to its three vertices, weighted by the size of the
+*  triangle instead of normalized, so a triangle costs no square root or division. Triangles with
+*  no texture space (UVs in a line, or not finite) add nothing. The vertices are then finished four
+*  at a time: the tangent is made perpendicular to the normal and the binormal is cross(normal,
+*  tangent) on the side the texture mapping puts it. A vertex left without a tangent gets any
+*  direction perpendicular to its normal. Tools/Benchmarks/TangentFramesBenchmark.cpp checks the
+*  frames against a scalar loop. */
+class TangentFrames
+{
+public:
+	static void Generate(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+};
@@ -0,0 +1,223 @@
+#include "VertexPacking.h"
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+constexpr float TANGENT_MAX = 1023.0f; // 10 bit unorm
+
+static int16_t ToSnorm16(float value)
+{
+	value = (value < -1.0f) ? -1.0f : ((value > 1.0f) ? 1.0f : value);
+	return static_cast<int16_t>(lroundf(value * 32767.0f));
+}
+
+// Same as the input assembler, -32768 and -32767 are both -1
+static float FromSnorm16(int16_t value)
+{
+	float result = value / 32767.0f;
+	return (result < -1.0f) ? -1.0f : result;
+}
+
+static uint32_t ToUnorm10(float value)
+{
+	float unorm = (value * 0.5f) + 0.5f;
+	unorm = (unorm < 0.0f) ? 0.0f : ((unorm > 1.0f) ? 1.0f : unorm);
+	return static_cast<uint32_t>(lroundf(unorm * TANGENT_MAX));
+}
+
+static float FromUnorm10(uint32_t value)
+{
+	return ((value / TANGENT_MAX) * 2.0f) - 1.0f;
+}
+
+static float SignNotZero(float value)
+{
+	return (value >= 0.0f) ? 1.0f : -1.0f;
+}
+
+static XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3((a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x));
+}
+
+static uint32_t PackTangent(const Vertex& vertex)
+{
+	float u, v;
+	VertexPacking::EncodeOctahedral(vertex.tangent, u, v);
+
+	// Which side of the normal and tangent the binormal is on
+	XMFLOAT3 binormal = Cross(vertex.normal, vertex.tangent);
+	float side = (binormal.x * vertex.biNormal.x) + (binormal.y * vertex.biNormal.y) + (binormal.z * vertex.biNormal.z);
+	uint32_t sign = (side < 0.0f) ? 0 : 3;
+	return ToUnorm10(u) | (ToUnorm10(v) << 10) | (sign << 30);
+}
+
+// Rebuilds normal, tangent and binormal the way the packed vertex shader does
+static void UnpackFrame(const int16_t normal[2], uint32_t tangent, Vertex& vertex)
+{
+	vertex.normal = VertexPacking::DecodeOctahedral(FromSnorm16(normal[0]), FromSnorm16(normal[1]));
+	vertex.tangent = VertexPacking::DecodeOctahedral(FromUnorm10(tangent & 0x3FF), FromUnorm10((tangent >> 10) & 0x3FF));
+
+	float sign = ((tangent >> 30) == 0) ? -1.0f : 1.0f;
+	XMFLOAT3 binormal = Cross(vertex.normal, vertex.tangent);
+	vertex.biNormal = XMFLOAT3(binormal.x * sign, binormal.y * sign, binormal.z * sign);
+}
+
+// Round to nearest even, values past the half range become infinity
+uint16_t VertexPacking::FloatToHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t magnitude = bits & 0x7FFFFFFF;
+
+	if (magnitude > 0x7F800000) // NaN
+		return static_cast<uint16_t>(sign | 0x7E00);
+	if (magnitude >= 0x477FF000) // Rounds past 65504
+		return static_cast<uint16_t>(sign | 0x7C00);
+
+	if (magnitude < 0x38800000) // Below the smallest normal half, 2^-14
+	{
+		if (magnitude < 0x33000000) // Below half of the smallest subnormal half, 2^-25
+			return static_cast<uint16_t>(sign);
+
+		uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+		uint32_t shift = 126 - (magnitude >> 23);
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1)))
+			half++;
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	uint32_t half = (magnitude - 0x38000000) >> 13; // Exponent bias 127 to 15
+	uint32_t remainder = magnitude & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		half++;
+	return static_cast<uint16_t>(sign | half);
+}
+
+float VertexPacking::HalfToFloat(uint16_t half)
+{
+	uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1F;
+	uint32_t mantissa = half & 0x3FF;
+
+	if (exponent == 0)
+	{
+		float value = ldexpf(static_cast<float>(mantissa), -24);
+		return (sign != 0) ? -value : value;
+	}
+
+	uint32_t bits = (exponent == 31) ? (sign | 0x7F800000 | (mantissa << 13)) : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// Direction to a point of the square [-1, 1], the lower half of the octahedron is folded over the corners
+void VertexPacking::EncodeOctahedral(const XMFLOAT3& direction, float& u, float& v)
+{
+	float length = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+	if (!(length > 0.0f))
+	{
+		u = 0.0f;
+		v = 0.0f;
+		return;
+	}
+
+	u = direction.x / length;
+	v = direction.y / length;
+	if (direction.z < 0.0f)
+	{
+		float foldedU = (1.0f - fabsf(v)) * SignNotZero(u);
+		float foldedV = (1.0f - fabsf(u)) * SignNotZero(v);
+		u = foldedU;
+		v = foldedV;
+	}
+}
+
+XMFLOAT3 VertexPacking::DecodeOctahedral(float u, float v)
+{
+	XMFLOAT3 direction(u, v, 1.0f - fabsf(u) - fabsf(v));
+	float fold = (direction.z < 0.0f) ? -direction.z : 0.0f;
+	direction.x += (direction.x >= 0.0f) ? -fold : fold;
+	direction.y += (direction.y >= 0.0f) ? -fold : fold;
+
+	float length = sqrtf((direction.x * direction.x) + (direction.y * direction.y) + (direction.z * direction.z));
+	return XMFLOAT3(direction.x / length, direction.y / length, direction.z / length);
+}
+
+PositionQuantization VertexPacking::GetQuantization(const Vertex* vertices, size_t vertexCount)
+{
+	PositionQuantization quantization = { XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f };
+	if (vertexCount == 0)
+		return quantization;
+
+	XMFLOAT3 minimum = vertices[0].pos;
+	XMFLOAT3 maximum = vertices[0].pos;
+	for (size_t i = 1; i < vertexCount; i++)
+	{
+		const XMFLOAT3& pos = vertices[i].pos;
+		minimum = XMFLOAT3(fminf(minimum.x, pos.x), fminf(minimum.y, pos.y), fminf(minimum.z, pos.z));
+		maximum = XMFLOAT3(fmaxf(maximum.x, pos.x), fmaxf(maximum.y, pos.y), fmaxf(maximum.z, pos.z));
+	}
+
+	quantization.center = XMFLOAT3((minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f);
+	float scale = fmaxf(maximum.x - minimum.x, fmaxf(maximum.y - minimum.y, maximum.z - minimum.z)) * 0.5f;
+	quantization.scale = (scale > 0.0f) ? scale : 1.0f;
+	return quantization;
+}
+
+PackedVertex VertexPacking::Pack(const Vertex& vertex)
+{
+	PackedVertex packed;
+	packed.pos = vertex.pos;
+	packed.texCoord[0] = FloatToHalf(vertex.texCoord.x);
+	packed.texCoord[1] = FloatToHalf(vertex.texCoord.y);
+
+	float u, v;
+	EncodeOctahedral(vertex.normal, u, v);
+	packed.normal[0] = ToSnorm16(u);
+	packed.normal[1] = ToSnorm16(v);
+	packed.tangent = PackTangent(vertex);
+	return packed;
+}
+
+QuantizedVertex VertexPacking::Quantize(const Vertex& vertex, const PositionQuantization& quantization)
+{
+	PackedVertex packed = Pack(vertex);
+	QuantizedVertex quantized;
+	quantized.pos[0] = ToSnorm16((vertex.pos.x - quantization.center.x) / quantization.scale);
+	quantized.pos[1] = ToSnorm16((vertex.pos.y - quantization.center.y) / quantization.scale);
+	quantized.pos[2] = ToSnorm16((vertex.pos.z - quantization.center.z) / quantization.scale);
+	quantized.pos[3] = 32767;
+	quantized.texCoord[0] = packed.texCoord[0];
+	quantized.texCoord[1] = packed.texCoord[1];
+	quantized.normal[0] = packed.normal[0];
+	quantized.normal[1] = packed.normal[1];
+	quantized.tangent = packed.tangent;
+	return quantized;
+}
+
+Vertex VertexPacking::Unpack(const PackedVertex& vertex)
+{
+	Vertex unpacked;
+	unpacked.pos = vertex.pos;
+	unpacked.texCoord = XMFLOAT2(HalfToFloat(vertex.texCoord[0]), HalfToFloat(vertex.texCoord[1]));
+	UnpackFrame(vertex.normal, vertex.tangent, unpacked);
+	return unpacked;
+}
+
+Vertex VertexPacking::Unpack(const QuantizedVertex& vertex, const PositionQuantization& quantization)
+{
+	Vertex unpacked;
+	unpacked.pos = XMFLOAT3(quantization.center.x + (FromSnorm16(vertex.pos[0]) * quantization.scale),
+	                        quantization.center.y + (FromSnorm16(vertex.pos[1]) * quantization.scale),
+	                        quantization.center.z + (FromSnorm16(vertex.pos[2]) * quantization.scale));
+	unpacked.texCoord = XMFLOAT2(HalfToFloat(vertex.texCoord[0]), HalfToFloat(vertex.texCoord[1]));
+	UnpackFrame(vertex.normal, vertex.tangent, unpacked);
+	return unpacked;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "../Graphics/Vertex.h"
+
+// Quantized positions are center + pos * scale, the scale is the same on every axis so normals stay correct
+struct PositionQuantization
+{
+	DirectX::XMFLOAT3 center;
+	float scale;
+};
+
+/* Conversion of Vertex to the packed vertex formats and back.
+*
+*  Unpacking is what the vertex shader does with the packed formats, it is here to measure the
+*  error of a packed mesh. Worst cases:
+*  texture coordinates   half float, 2^-11 relative (1/2048 of a texture at 1.0)
+*  normal                16 bit octahedral, under 0.05 degrees
+*  tangent               10 bit octahedral, under 0.25 degrees
+*  quantized position    half a step of 16 bits over the largest half extent, about scale / 65534
+*  Tools/Tests/VertexPackingTest.cpp checks these bounds. */
+class VertexPacking
+{
+public:
+	static uint16_t FloatToHalf(float value);
+	static float HalfToFloat(uint16_t half);
+
+	static void EncodeOctahedral(const DirectX::XMFLOAT3& direction, float& u, float& v);
+	static DirectX::XMFLOAT3 DecodeOctahedral(float u, float v);
+
+	static PositionQuantization GetQuantization(const Vertex* vertices, size_t vertexCount);
+
+	static PackedVertex Pack(const Vertex& vertex);
+	static QuantizedVertex Quantize(const Vertex& vertex, const PositionQuantization& quantization);
+	static Vertex Unpack(const PackedVertex& vertex);
+	static Vertex Unpack(const QuantizedVertex& vertex, const PositionQuantization& quantization);
+};
@@ -1,9 +1,11 @@
 #include "Engine.h"
+#include <ctime>
+#include "Simulation/InputReplay.h"
 
 bool Engine::Initialize(HINSTANCE hInstance, std::string window_title, std::string  window_class, int width, int height)
 {
 	timer.Start();
-	pickSpawnTimer.Start();
+	Profiler::SetThreadName("Main");
 
 	if (!this->render_window.Initialize(this, hInstance, window_title, window_class, width, height))
 		return false;
@@ -11,13 +13,20 @@ bool Engine::Initialize(HINSTANCE hInstance, std::string window_title, std::stri
 	if (!gfx.Initialize(this->render_window.GetHWND(), width, height))
 		return false;
 
+	// New pickup layout every run, a fixed seed replays the same game
+	simulation.Reset(static_cast<uint64_t>(time(nullptr)));
+	inputLog.Begin(simulation.GetSeed(), simulationTimestep.GetTickRate());
+
+	// Large numbers of animations and parented objects are updated across the worker threads
+	animationSystem.SetWorkerPool(&workers);
+	GameObject3D::GetHierarchy().SetWorkerPool(&workers);
+
 	// Animation Test
-	AnimationProperty* rotateWindmill = animationSystem.CreateAnimation(&gfx.windmillBlades, AnimationType::Rotation, 1, XMFLOAT3(0.0f, 0.0f, XM_2PI), true);
-	if (rotateWindmill == nullptr)
+	AnimationHandle rotateWindmill = animationSystem.CreateAnimation(&gfx.windmillBlades, AnimationType::Rotation, 1, XMFLOAT3(0.0f, 0.0f, XM_2PI), true);
+	if (!animationSystem.Start(rotateWindmill))
 		OutputDebugStringA("Animation failed to create\n");
 	else
 		OutputDebugStringA("Created animation\n");
-	rotateWindmill->Start();
 
 	// Pass anomator pointer to game logic
 	gfx.snake3D.SetAnimator(&animationSystem);
@@ -34,27 +43,40 @@ bool Engine::ProcessMessages()
 
 void Engine::Update()
 {
+	PROFILE_ZONE("Engine::Update");
+
 	float dt = timer.GetMilisecondsElapsed();
 	timer.Restart();
 
-	// Updates the childs position in relation to parent
-	ParentChildPositionUpdater();
-
 	// Animation Updates
-	animationSystem.Update();
-
-	// Game Updates
-	gfx.snake3D.Update(dt);
+	animationSystem.Update(dt);
 
 	while (!keyboard.CharBufferIsEmpty())
 	{
 		unsigned char ch = keyboard.ReadChar();
 	}
 
+	// Key events are recorded with the tick they came in on, the simulation only sees keys through the log
 	while (!keyboard.KeyBufferIsEmpty())
 	{
 		KeyboardEvent kbe = keyboard.ReadKey();
 		unsigned char keycode = kbe.GetKeyCode();
+
+		InputEvent event;
+		event.tick = simulation.GetTick();
+		event.type = kbe.IsPress() ? InputEventType::KeyPress : InputEventType::KeyRelease;
+		event.key = keycode;
+		inputLog.Add(event);
+		inputKeyState.Apply(event);
+	}
+
+	if (gfx.IsThirdPersonCameraEnabled() != inputKeyState.IsRelativeSteering())
+	{
+		InputEvent event;
+		event.tick = simulation.GetTick();
+		event.type = gfx.IsThirdPersonCameraEnabled() ? InputEventType::SteeringOn : InputEventType::SteeringOff;
+		inputLog.Add(event);
+		inputKeyState.Apply(event);
 	}
 
 	while (!mouse.EventBufferIsEmpty())
@@ -125,21 +147,20 @@ void Engine::Update()
 			gfx.cameraRig.AdjustParentRotationOffset(0.0f, (cameraSpeed * dt) / 200, 0.0f);
 	}
 
-	/* Start Game */
-	static bool gameStarted = false;
-	static bool gameOver = false;
-	static bool wasTurned = false;
-
-	if (keyboard.KeyIsPressed(VK_RETURN))
+	/* Game rules run in the simulation at a fixed tick rate, independent of the frame rate.
+	   The renderer reads the result back in RenderFrame and interpolates between the last two ticks */
+	SimulationInput input = inputKeyState.ToSimulationInput();
+	int ticks = simulationTimestep.Advance(dt);
 	{
-		gameStarted = true;
+		PROFILE_ZONE("SnakeSimulation::Step");
+		for (int i = 0; i < ticks; i++)
+			simulation.Step(input, simulationTimestep.GetTickLength());
 	}
-	if (!gameStarted)// || gameOver)
+
+	if (!simulation.IsGameStarted())
 		return;
 
 	// Charecter 2 test
-	//gfx.snake3D.GetCharacter()->MoveForward(dt);
-
 	if (keyboard.KeyIsPressed('D'))
 	{
 		gfx.snake3D.GetCharacter()->RotateRight(dt);
@@ -148,249 +169,34 @@ void Engine::Update()
 	{
 		gfx.snake3D.GetCharacter()->RotateLeft(dt);
 	}
-
-	/* Game over handling - If characters goes beyond play area then game over*/
-	if (gfx.character.GetPositionFloat3().x > 980.0 || gfx.character.GetPositionFloat3().x < -980)
-		gameOver = true;
-	if (gfx.character.GetPositionFloat3().z > 980.0 || gfx.character.GetPositionFloat3().x < -980)
-		gameOver = true;
-
-	// Handle pickup spawns
-	int randomTime = rand() % 6000 + 4500;
-	if (pickSpawnTimer.GetMilisecondsElapsed() > randomTime)
-	{
-		gfx.SpawnPickup();
-		pickSpawnTimer.Restart();
-	}
-
-	// Handle pickup collisions
-	for (size_t i = 0; i < gfx.pickupOrbList.size(); i++)
-	{
-		if (Engine::CompareFloat(gfx.pickupOrbList.at(i)->GetPositionFloat3(), gfx.character.GetPositionFloat3(), 40) && gfx.pickupOrbList.at(i)->IsVisible())
-		{   // Orb was picked up
-			gfx.pickupOrbList.at(i)->SetVisible(false);
-			gfx.score++;
-			gfx.CreateSnakeChild();
-			gfx.characterSpeedModifier += 0.2f;
-		}
-	}
-
-	// Handling Child movement/collisions
-	for (size_t i = 0; i < gfx.snakeBodyList.size(); i++)
-	{
-		GameObject3D* parent = gfx.snakeBodyList.at(i)->GetParent();
-
-		// Handle head/child collisions
-		if (Engine::CompareFloat(gfx.character.GetPositionFloat3(), gfx.snakeBodyList.at(i)->GetPositionFloat3(), 73/2))
-			gameOver = true;
-
-		// Body moves in parents fwd vector if it doesnt change direction
-		if (!parent->movePending)
-		{
-			XMVECTOR targetVector = parent->GetForwardVector();
-			//gfx.snakeBodyList.at(i)->SetRotation(parent->GetRotationVector());
-			gfx.snakeBodyList.at(i)->AdjustPosition(((targetVector / 100) * gfx.characterSpeedModifier) * dt);
-		}
-
-		// Body moves straight while parent is changing direction
-		if (parent->movePending)
-		{
-			XMVECTOR targetVector = gfx.snakeBodyList.at(i)->GetForwardVector();
-			gfx.snakeBodyList.at(i)->AdjustPosition(((targetVector / 100) * gfx.characterSpeedModifier) * dt);
-
-			// Save position of parent when it turns
-			if (!gfx.snakeBodyList.at(i)->turnPending)
-			{
-				gfx.snakeBodyList.at(i)->positionAtTurn = parent->GetPositionFloat3(); 
-				gfx.snakeBodyList.at(i)->turnPending = true;
-			}		
-
-			// Checks if body has entered where parent turned
-			if (gfx.snakeBodyList.at(i)->turnPending)
-			{
-				XMFLOAT3 currentDirection;
-				bool passedTarget = false;
-				XMStoreFloat3(&currentDirection, gfx.snakeBodyList.at(i)->GetForwardVector());
-
-				// Check if child has passed its target depending on its direction
-				if (currentDirection.x > 0.1f)
-					if (gfx.snakeBodyList.at(i)->positionAtTurn.x - gfx.snakeBodyList.at(i)->GetPositionFloat3().x < 0)
-						passedTarget = true;
-
-				if (currentDirection.x < -0.1f)
-					if (gfx.snakeBodyList.at(i)->GetPositionFloat3().x - gfx.snakeBodyList.at(i)->positionAtTurn.x < 0)
-						passedTarget = true;
-
-				if (currentDirection.z > 0.1f)
-					if (gfx.snakeBodyList.at(i)->positionAtTurn.z - gfx.snakeBodyList.at(i)->GetPositionFloat3().z < 0)
-						passedTarget = true;
-
-				if (currentDirection.z < -0.1f)
-					if (gfx.snakeBodyList.at(i)->GetPositionFloat3().z - gfx.snakeBodyList.at(i)->positionAtTurn.z < 0)
-						passedTarget = true;
-
-
-				// Check if FWD vector exceeds 73
-
-				if (passedTarget)
-				{ // Has moved 73 paces
-					// Sets last childs movepending to false
-					if (i == gfx.snakeBodyList.size() - 1) // Last child
-						gfx.snakeBodyList.at(i)->movePending = false;
-
-					gfx.snakeBodyList.at(i)->movePending = true;
-					parent->movePending = false;	
-
-					gfx.snakeBodyList.at(i)->turnPending = false;
-	    			gfx.snakeBodyList.at(i)->SetRotation(parent->GetRotationVector()); 
-
-					// Adjust position of child to perfectly match behind parent
-					XMFLOAT3 parentDirection;
-					XMStoreFloat3(&parentDirection, parent->GetForwardVector());
-					if (parentDirection.z > 0.1f)
-						gfx.snakeBodyList.at(i)->SetPosition(parent->GetPositionFloat3().x, parent->GetPositionFloat3().y, parent->GetPositionFloat3().z - 73.0f);
-					else if (parentDirection.z < -0.1f)
-						gfx.snakeBodyList.at(i)->SetPosition(parent->GetPositionFloat3().x, parent->GetPositionFloat3().y, parent->GetPositionFloat3().z + 73.0f);
-					else if (parentDirection.x > 0.1f)
-						gfx.snakeBodyList.at(i)->SetPosition(parent->GetPositionFloat3().x - 73.0f, parent->GetPositionFloat3().y, parent->GetPositionFloat3().z);
-					else if (parentDirection.x < -0.1f)
-						gfx.snakeBodyList.at(i)->SetPosition(parent->GetPositionFloat3().x + 73.0f, parent->GetPositionFloat3().y, parent->GetPositionFloat3().z);
-						
-					wasTurned = true;
-				}
-			}
-		}
-	}
-
-	// Move Character - Speed is modified with characterSpeedModifier
-	gfx.character.AdjustPosition(((gfx.character.GetForwardVector() / 100) * gfx.characterSpeedModifier) * dt);
-
-	if (wasTurned)
-	{
-		wasTurned = false;
-		return;
-	}
-
-	if (gfx.character.movePending)
-		return;
-
-	if (gfx.character.IsAnimationActive())
-	{
-		return;
-	}
-
-	/* ******* Character Movement ******* */
-	static std::string characterDirection = "UP";
-	if (keyboard.KeyIsPressed('D') && characterDirection != "LEFT" && characterDirection != "RIGHT")
-	{
-		if (gfx.IsThirdPersonCameraEnabled())
-		{
-			AnimationProperty* turnRightAnim = animationSystem.CreateAnimation(&gfx.character, AnimationType::Rotation, 12, XMFLOAT3(0.0f, XM_PI / 2.0f, 0.0f));
-			if (turnRightAnim == nullptr)
-				return;
-			turnRightAnim->Start();
-			//gfx.character.AdjustRotation(0.0f, XM_PI / 2, 0.0f);
-			gfx.character.movePending = true;
-			return;
-		}
-		gfx.character.SetRotation(0.0f, XM_PI / 2.0f, 0.0f);
-		characterDirection = "RIGHT";
-		gfx.character.movePending = true;
-	}
-	if (keyboard.KeyIsPressed('A') && characterDirection != "RIGHT" && characterDirection != "LEFT")
-	{
-		if (gfx.IsThirdPersonCameraEnabled())
-		{
-			AnimationProperty* turnLeftAnim = animationSystem.CreateAnimation(&gfx.character, AnimationType::Rotation, 12, XMFLOAT3(0.0f, -XM_PI / 2.0f, 0.0f));
-			if (turnLeftAnim == nullptr)
-				return;
-			turnLeftAnim->Start();
-			//gfx.character.AdjustRotation(0.0f, -XM_PI / 2, 0.0f);
-			gfx.character.movePending = true;
-			return;
-		}
-		gfx.character.SetRotation(0.0f, -XM_PI / 2.0f, 0.0f);		
-		characterDirection = "LEFT";
-		gfx.character.movePending = true;
-	}
-
-	if (keyboard.KeyIsPressed('W') && characterDirection != "UP" && characterDirection != "DOWN")
-	{
-		if (gfx.IsThirdPersonCameraEnabled())
-			return;
-		gfx.character.SetRotation(0.0f, 0.0f, 0.0f);		
-		characterDirection = "UP";
-		gfx.character.movePending = true;
-	}
-
-	if (keyboard.KeyIsPressed('S') && characterDirection != "UP" && characterDirection != "DOWN")
-	{
-		if (gfx.IsThirdPersonCameraEnabled())
-			return;
-		gfx.character.SetRotation(0.0f, XM_PI, 0.0f);	
-		characterDirection = "DOWN";
-		gfx.character.movePending = true;
-	}
 }
 
 void Engine::RenderFrame()
 {
+	PROFILE_ZONE("Engine::RenderFrame");
+
+	gfx.UpdateFromSimulation(simulation, simulationTimestep.GetAlpha());
+	// Children follow the character from this frame instead of the last one
+	ParentChildPositionUpdater();
 	gfx.RenderFrame();
 }
 
-void Engine::ParentChildPositionUpdater()
+// Writes the input of the session so far, Tools/Replay plays it back without a window
+bool Engine::SaveInputLog(const std::string& filePath)
 {
-	for (size_t i = 0; i < GameObject3D::GetParentedObjects().size(); i++)
+	inputLog.End(simulation.GetTick(), InputReplay::HashState(simulation));
+	if (!inputLog.Save(filePath))
 	{
-		GameObject3D* parent = GameObject3D::GetParentedObjects().at(i)->GetParent();
-		GameObject3D* gameObject = GameObject3D::GetParentedObjects().at(i);
-		if (parent != nullptr && gameObject->IsParentTracking())
-		{
-			// Set position of child object to parent with offsets added.
-			gameObject->SetPosition(parent->GetPositionVector() + (
-				(parent->GetForwardVector() * gameObject->GetParentOffset().x) +
-				(parent->GetUpVector() * gameObject->GetParentOffset().y) +
-				(parent->GetRightVector() * gameObject->GetParentOffset().z)));
-
-			// Set rotation of child object to parent with offsets added.
-			gameObject->SetRotation(parent->GetRotationVector() + gameObject->GetParentRotationOffsetVector());
-		}
+		ErrorLogger::Log("Failed to save input log " + filePath);
+		return false;
 	}
+	return true;
 }
 
-bool Engine::CompareFloat(XMFLOAT3 current, XMFLOAT3 previous, float epsilon) {
-	float largestXValue = 0;
-	float smallestXValue = 0;
-	float largestZValue = 0;
-	float smallestZValue = 0;
-
-	// Get largest X value
-	if (current.x > previous.x)
-	{
-		largestXValue = current.x;
-		smallestXValue = previous.x;
-	}
-	else
-	{
-		largestXValue = previous.x;
-		smallestXValue = current.x;
-	}
-
-	// Get largest Z value
-	if (current.z > previous.z)
-	{
-		largestZValue = current.z;
-		smallestZValue = previous.z;
-	}
-	else
-	{
-		largestZValue = previous.z;
-		smallestZValue = current.z;
-	}
+void Engine::ParentChildPositionUpdater()
+{
+	PROFILE_ZONE("Engine::ParentChildPositionUpdater");
 
-	if ((fabs(largestXValue - smallestXValue) < epsilon) && (fabs(largestZValue - smallestZValue) < epsilon))
-	{
-		return true; //they are same
-	}
-	return false; //they are not same
-}
+	// Parents are placed before their children, so a chain like camera, camera rig, character is done in one pass
+	GameObject3D::GetHierarchy().Update();
+}
\ No newline at end of file
@@ -2,6 +2,12 @@
 #include "WindowContainer.h"
 #include "Timer.h"
 #include "Animation/Animation.h"
+#include "Simulation/SnakeSimulation.h"
+#include "Simulation/FixedTimestep.h"
+#include "Simulation/InputLog.h"
+#include "Profiler/Profiler.h"
+#include "Threading/WorkerPool.h"
+#include "Graphics/SceneHierarchy.h"
 
 class Engine : WindowContainer
 {
@@ -11,10 +17,16 @@ public:
 	void Update();
 	void RenderFrame();
 	void ParentChildPositionUpdater();
-	static bool CompareFloat(XMFLOAT3 current, XMFLOAT3 previous, float epsilon = 1.0f);
+	bool SaveInputLog(const std::string& filePath);
 private:
 	Timer timer;
-	Timer pickSpawnTimer;
 
+	WorkerPool workers;
 	AnimationSystem animationSystem;
+	SnakeSimulation simulation;
+	FixedTimestep simulationTimestep;
+
+	// Every key event of the session, replaying it gives the same game
+	InputLog inputLog;
+	InputKeyState inputKeyState;
 };
\ No newline at end of file
@@ -3,12 +3,11 @@
 Camera3D::Camera3D()
 {
 	pos = XMFLOAT3(0.0f, 0.0f, 0.0f);
-	posVector = XMLoadFloat3(&pos);
 	rot = XMFLOAT3(0.0f, 0.0f, 0.0f);
-	rotVector = XMLoadFloat3(&rot);
+	scale = XMFLOAT3(1.0f, 1.0f, 1.0f);
 	SetParentOffset(0.0f, 0.0f, 0.0f);
 	SetParentRotationOffset(0.0f, 0.0f, 0.0f);
-	UpdateMatrix();
+	UpdateTransform();
 }
 
 void Camera3D::SetProjectionValues(float fovDegrees, float aspectRatio, float nearZ, float farZ)
@@ -17,8 +16,9 @@ void Camera3D::SetProjectionValues(float fovDegrees, float aspectRatio, float ne
 	projectionMatrix = XMMatrixPerspectiveFovLH(fovRadians, aspectRatio, nearZ, farZ);
 }
 
-const XMMATRIX& Camera3D::GetViewMatrix() const
+const XMMATRIX& Camera3D::GetViewMatrix()
 {
+	UpdateTransform();
 	return viewMatrix;
 }
 
@@ -29,6 +29,7 @@ const XMMATRIX& Camera3D::GetProjectionMatrix() const
 
 void Camera3D::UpdateMatrix() //Updates view matrix and also updates the movement vectors
 {
+	XMVECTOR posVector = XMLoadFloat3(&pos);
 	//Calculate Camera3D rotation matrix
 	XMMATRIX camRotationMatrix = XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z);
 	//Calculate unit vector of cam target based off Camera3D forward value transformed by cam rotation matrix
@@ -39,6 +40,4 @@ void Camera3D::UpdateMatrix() //Updates view matrix and also updates the movemen
 	XMVECTOR upDir = XMVector3TransformCoord(DEFAULT_UP_VECTOR, camRotationMatrix);
 	//Rebuild view matrix
 	viewMatrix = XMMatrixLookAtLH(posVector, camTarget, upDir);
-
-	UpdateDirectionVectors();
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ public:
 	Camera3D();
 	void SetProjectionValues(float fovDegrees, float aspectRatio, float nearZ, float farZ);
 
-	const XMMATRIX& GetViewMatrix() const;
+	const XMMATRIX& GetViewMatrix();
 	const XMMATRIX& GetProjectionMatrix() const;
 
 private:
@@ -1,8 +1,11 @@
 #include "GameObject.h"
 
-const XMVECTOR& GameObject::GetPositionVector() const
+std::atomic<uint64_t> GameObject::transformChanges(0);
+std::atomic<uint64_t> GameObject::transformRebuilds(0);
+
+XMVECTOR GameObject::GetPositionVector() const
 {
-	return this->posVector;
+	return XMLoadFloat3(&this->pos);
 }
 
 const XMFLOAT3& GameObject::GetPositionFloat3() const
@@ -10,9 +13,9 @@ const XMFLOAT3& GameObject::GetPositionFloat3() const
 	return this->pos;
 }
 
-const XMVECTOR& GameObject::GetRotationVector() const
+XMVECTOR GameObject::GetRotationVector() const
 {
-	return this->rotVector;
+	return XMLoadFloat3(&this->rot);
 }
 
 const XMFLOAT3& GameObject::GetRotationFloat3() const
@@ -28,42 +31,39 @@ const XMFLOAT3& GameObject::GetScaleFloat3() const
 void GameObject::SetPosition(const XMVECTOR& pos)
 {
 	XMStoreFloat3(&this->pos, pos);
-	this->posVector = pos;
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::SetPosition(const XMFLOAT3& pos)
 {
 	this->pos = pos;
-	this->posVector = XMLoadFloat3(&this->pos);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::SetPosition(float x, float y, float z)
 {
 	this->pos = XMFLOAT3(x, y, z);
-	this->posVector = XMLoadFloat3(&this->pos);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::SetScale(const XMFLOAT3& scale)
 {
 	this->scale = scale;
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::SetScale(float x, float y, float z)
 {
 	this->scale = XMFLOAT3(x, y, z);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustScale(const XMFLOAT3& pos)
 {
-	this->scale.x += pos.y;
+	this->scale.x += pos.x;
 	this->scale.y += pos.y;
 	this->scale.z += pos.z;
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustScale(float x, float y, float z)
@@ -71,23 +71,21 @@ void GameObject::AdjustScale(float x, float y, float z)
 	this->scale.x += x;
 	this->scale.y += y;
 	this->scale.z += z;
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustPosition(const XMVECTOR& pos)
 {
-	this->posVector += pos;
-	XMStoreFloat3(&this->pos, this->posVector);
-	this->UpdateMatrix();
+	XMStoreFloat3(&this->pos, XMLoadFloat3(&this->pos) + pos);
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustPosition(const XMFLOAT3& pos)
 {
-	this->pos.x += pos.y;
+	this->pos.x += pos.x;
 	this->pos.y += pos.y;
 	this->pos.z += pos.z;
-	this->posVector = XMLoadFloat3(&this->pos);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustPosition(float x, float y, float z)
@@ -95,36 +93,31 @@ void GameObject::AdjustPosition(float x, float y, float z)
 	this->pos.x += x;
 	this->pos.y += y;
 	this->pos.z += z;
-	this->posVector = XMLoadFloat3(&this->pos);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::SetRotation(const XMVECTOR& rot)
 {
-	this->rotVector = rot;
 	XMStoreFloat3(&this->rot, rot);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::SetRotation(const XMFLOAT3& rot)
 {
 	this->rot = rot;
-	this->rotVector = XMLoadFloat3(&this->rot);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::SetRotation(float x, float y, float z)
 {
 	this->rot = XMFLOAT3(x, y, z);
-	this->rotVector = XMLoadFloat3(&this->rot);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustRotation(const XMVECTOR& rot)
 {
-	this->rotVector += rot;
-	XMStoreFloat3(&this->rot, this->rotVector);
-	this->UpdateMatrix();
+	XMStoreFloat3(&this->rot, XMLoadFloat3(&this->rot) + rot);
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustRotation(const XMFLOAT3& rot)
@@ -132,8 +125,7 @@ void GameObject::AdjustRotation(const XMFLOAT3& rot)
 	this->rot.x += rot.x;
 	this->rot.y += rot.y;
 	this->rot.z += rot.z;
-	this->rotVector = XMLoadFloat3(&this->rot);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
 }
 
 void GameObject::AdjustRotation(float x, float y, float z)
@@ -141,18 +133,41 @@ void GameObject::AdjustRotation(float x, float y, float z)
 	this->rot.x += x;
 	this->rot.y += y;
 	this->rot.z += z;
-	this->rotVector = XMLoadFloat3(&this->rot);
-	this->UpdateMatrix();
+	this->MarkTransformDirty();
+}
+
+// Rebuilds the matrices and direction vectors now if the transform changed since they were last built
+void GameObject::UpdateTransform()
+{
+	if (!isTransformDirty)
+		return;
+
+	isTransformDirty = false;
+	transformRebuilds.fetch_add(1, std::memory_order_relaxed);
+	UpdateMatrix();
+}
+
+// Changes made to transforms and how many rebuilds they took, every change without a rebuild is one avoided
+GameObject::TransformCounters GameObject::GetTransformCounters()
+{
+	TransformCounters counters;
+	counters.changes = transformChanges.load(std::memory_order_relaxed);
+	counters.rebuilds = transformRebuilds.load(std::memory_order_relaxed);
+	return counters;
 }
 
-bool GameObject::IsAnimationActive()
+void GameObject::ResetTransformCounters()
 {
-	return this->isAnimationActive;
+	transformChanges.store(0, std::memory_order_relaxed);
+	transformRebuilds.store(0, std::memory_order_relaxed);
 }
 
-void GameObject::SetAnimationActive(bool state)
+/* Only flags the transform, the matrices are rebuilt once when something reads them.
+*  Moving an object several times in a frame then costs a single rebuild */
+void GameObject::MarkTransformDirty()
 {
-	isAnimationActive = state;
+	isTransformDirty = true;
+	transformChanges.fetch_add(1, std::memory_order_relaxed);
 }
 
 void GameObject::UpdateMatrix()
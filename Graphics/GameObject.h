@@ -1,12 +1,13 @@
 #pragma once
+#include <atomic>
 #include "Model.h"
 
 class GameObject
 {
 public:
-	const XMVECTOR& GetPositionVector() const;
+	XMVECTOR GetPositionVector() const;
 	const XMFLOAT3& GetPositionFloat3() const;
-	const XMVECTOR& GetRotationVector() const;
+	XMVECTOR GetRotationVector() const;
 	const XMFLOAT3& GetRotationFloat3() const;
 	const XMFLOAT3& GetScaleFloat3() const;
 
@@ -27,29 +28,29 @@ public:
 	void AdjustRotation(const XMFLOAT3& rot);
 	void AdjustRotation(float x, float y, float z);
 
-	XMVECTOR previousRotation;
-	XMVECTOR previousPosition;
+	void UpdateTransform();
 
-	// animation
-	bool IsAnimationActive();
-	void SetAnimationActive(bool state);
-
-	bool movePending = false;
-	XMFLOAT3 positionAtTurn;
-	bool turnPending = false;
+	struct TransformCounters
+	{
+		uint64_t changes;  // Calls that changed a transform
+		uint64_t rebuilds; // Times the matrices were actually rebuilt
+	};
+	static TransformCounters GetTransformCounters();
+	static void ResetTransformCounters();
 
 	XMFLOAT3 pos; // move to public so it can be debugged easily, put in protected after
 
 protected:
+	void MarkTransformDirty();
 	virtual void UpdateMatrix();
 
-	XMVECTOR posVector;
-	XMVECTOR rotVector;
-	
+	// Only the floats are stored, vectors and matrices are made from them when they are needed
 	XMFLOAT3 rot;
 	XMFLOAT3 scale;
 
-private:
-	bool isAnimationActive = false;
+	bool isTransformDirty = true; // Matrices and direction vectors are out of date
 
+private:
+	static std::atomic<uint64_t> transformChanges;
+	static std::atomic<uint64_t> transformRebuilds;
 };
\ No newline at end of file
@@ -1,4 +1,17 @@
 #include "GameObject3D.h"
+#include "SceneHierarchy.h"
+
+const XMVECTOR GameObject3D::DEFAULT_FORWARD_VECTOR = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+const XMVECTOR GameObject3D::DEFAULT_BACKWARD_VECTOR = XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f);
+const XMVECTOR GameObject3D::DEFAULT_UP_VECTOR = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+const XMVECTOR GameObject3D::DEFAULT_DOWN_VECTOR = XMVectorSet(0.0f, -1.0f, 0.0f, 0.0f);
+const XMVECTOR GameObject3D::DEFAULT_LEFT_VECTOR = XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f);
+const XMVECTOR GameObject3D::DEFAULT_RIGHT_VECTOR = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+
+GameObject3D::~GameObject3D()
+{
+	GetHierarchy().Remove(this);
+}
 
 void GameObject3D::SetLookAtPos(XMFLOAT3 lookAtPos)
 {
@@ -28,112 +41,89 @@ void GameObject3D::SetLookAtPos(XMFLOAT3 lookAtPos)
 	SetRotation(pitch, yaw, 0.0f);
 }
 
-const XMVECTOR& GameObject3D::GetForwardVector(bool omitY)
+/* Directions follow the pitch and yaw of the object, roll is left out.
+*  With omitY the pitch is left out as well, so the direction stays level with the ground */
+XMVECTOR GameObject3D::GetForwardVector(bool omitY) const
 {
-	if (omitY)
-		return vec_forward_noY;
-	else
-		return vec_forward;
+	float pitch = omitY ? 0.0f : rot.x;
+	return XMVectorSet(sinf(rot.y) * cosf(pitch), -sinf(pitch), cosf(rot.y) * cosf(pitch), 0.0f);
 }
 
-const XMVECTOR& GameObject3D::GetRightVector(bool omitY)
+XMVECTOR GameObject3D::GetRightVector(bool omitY) const
 {
-	if (omitY)
-		return vec_right_noY;
-	else
-		return vec_right;
+	return XMVectorSet(cosf(rot.y), 0.0f, -sinf(rot.y), 0.0f);
 }
 
-const XMVECTOR& GameObject3D::GetBackwardVector(bool omitY)
+XMVECTOR GameObject3D::GetBackwardVector(bool omitY) const
 {
-	if (omitY)
-		return vec_backward_noY;
-	else
-		return vec_backward;
+	return XMVectorNegate(GetForwardVector(omitY));
 }
 
-const XMVECTOR& GameObject3D::GetLeftVector(bool omitY)
+XMVECTOR GameObject3D::GetLeftVector(bool omitY) const
 {
-	if (omitY)
-		return vec_left_noY;
-	else
-		return vec_left;
+	return XMVectorNegate(GetRightVector(omitY));
 }
 
-const XMVECTOR& GameObject3D::GetUpVector()
+XMVECTOR GameObject3D::GetUpVector() const
 {
-	return vec_up;
+	return XMVectorSet(sinf(rot.y) * sinf(rot.x), cosf(rot.x), cosf(rot.y) * sinf(rot.x), 0.0f);
 }
 
-const XMVECTOR& GameObject3D::GetDownVector()
+XMVECTOR GameObject3D::GetDownVector() const
 {
-	return vec_down;
+	return XMVectorNegate(GetUpVector());
 }
 
-void GameObject3D::SetParent(GameObject3D* GameObject3D)
+/* Passing nullptr detaches the object and leaves it where it is.
+*  Fails when the object would become its own ancestor */
+bool GameObject3D::SetParent(GameObject3D* gameObject)
 {
-	// Removes parent from parent list if exists when nullptr i passed
-	if (GameObject3D == nullptr && parent != nullptr)
+	if (gameObject == nullptr)
 	{
-		GetParentedObjects().erase(std::remove(GetParentedObjects().begin(), GetParentedObjects().end(), this), GetParentedObjects().end());
-		return;
+		GetHierarchy().Detach(this);
+		return true;
 	}
 
-	if (GameObject3D == nullptr)
-		return;
-
 	// Sets up parent for this object
-	this->parent = GameObject3D;
-	GetParentedObjects().push_back(this);
-	parentPositionOffset.x = 0.0f;
-	parentPositionOffset.y = 0.0f;
-	parentPositionOffset.z = 0.0f;
+	if (!GetHierarchy().Attach(this, gameObject))
+		return false;
+
+	SetParentOffset(0.0f, 0.0f, 0.0f);
 	if (trackParentPosition)
 	{
-		SetPosition(GameObject3D->GetPositionVector());
+		SetPosition(gameObject->GetPositionVector());
 	}
+	return true;
 }
 
 void GameObject3D::SetParentOffset(const XMFLOAT3& offset)
 {
 	parentPositionOffset = offset;
-	parentPositionOffsetVector = XMLoadFloat3(&parentPositionOffset);
-	UpdateMatrix();
 }
 
 void GameObject3D::SetParentOffset(float x, float y, float z)
 {
 	parentPositionOffset = XMFLOAT3(x, y, z);
-	parentPositionOffsetVector = XMLoadFloat3(&parentPositionOffset);
-	UpdateMatrix();
 }
 
 void GameObject3D::SetParentOffset(const XMVECTOR& offset)
 {
-	parentPositionOffsetVector += offset;
-	XMStoreFloat3(&this->parentPositionOffset, parentPositionOffsetVector);
-	UpdateMatrix();
+	XMStoreFloat3(&parentPositionOffset, XMLoadFloat3(&parentPositionOffset) + offset);
 }
 
 void GameObject3D::SetParentRotationOffset(const XMFLOAT3& offset)
 {
 	parentRotationOffsetFloat3 = offset;
-	parentRotationOffsetVector = XMLoadFloat3(&parentRotationOffsetFloat3);
-	UpdateMatrix();
 }
 
 void GameObject3D::SetParentRotationOffset(float x, float y, float z)
 {
 	parentRotationOffsetFloat3 = XMFLOAT3(x, y, z);
-	parentRotationOffsetVector = XMLoadFloat3(&parentRotationOffsetFloat3);
-	UpdateMatrix();
 }
 
 void GameObject3D::SetParentRotationOffset(const XMVECTOR& offset)
 {
-	parentRotationOffsetVector += offset;
-	XMStoreFloat3(&parentRotationOffsetFloat3, parentRotationOffsetVector);
-	UpdateMatrix();
+	XMStoreFloat3(&parentRotationOffsetFloat3, XMLoadFloat3(&parentRotationOffsetFloat3) + offset);
 }
 
 void GameObject3D::AdjustParentRotationOffset(float x, float y, float z)
@@ -141,8 +131,6 @@ void GameObject3D::AdjustParentRotationOffset(float x, float y, float z)
 	parentRotationOffsetFloat3.x += x;
 	parentRotationOffsetFloat3.y += y;
 	parentRotationOffsetFloat3.z += z;
-	parentRotationOffsetVector = XMLoadFloat3(&parentRotationOffsetFloat3);
-	UpdateMatrix();
 }
 
 void GameObject3D::SetParentTracking(bool state)
@@ -150,54 +138,43 @@ void GameObject3D::SetParentTracking(bool state)
 	trackParentPosition = state;
 }
 
-const XMFLOAT3& GameObject3D::GetParentOffset()
+const XMFLOAT3& GameObject3D::GetParentOffset() const
 {
 	return parentPositionOffset;
 }
 
-const XMVECTOR& GameObject3D::GetParentOffsetVector()
+XMVECTOR GameObject3D::GetParentOffsetVector() const
 {
-	return parentPositionOffsetVector;
+	return XMLoadFloat3(&parentPositionOffset);
 }
 
-const XMFLOAT3& GameObject3D::GetParentRotationOffset()
+const XMFLOAT3& GameObject3D::GetParentRotationOffset() const
 {
 	return parentRotationOffsetFloat3;
 }
 
-const XMVECTOR& GameObject3D::GetParentRotationOffsetVector()
+XMVECTOR GameObject3D::GetParentRotationOffsetVector() const
 {
-	return parentRotationOffsetVector;
+	return XMLoadFloat3(&parentRotationOffsetFloat3);
 }
 
-const bool GameObject3D::IsParentTracking()
+const bool GameObject3D::IsParentTracking() const
 {
 	return trackParentPosition;
 }
 
-GameObject3D* GameObject3D::GetParent()
+GameObject3D* GameObject3D::GetParent() const
 {
-	return parent;
+	return node.parent;
 }
 
-void GameObject3D::UpdateMatrix()
+SceneHierarchy& GameObject3D::GetHierarchy()
 {
-	assert("UpdateMatrix must be overriden." && 0);
+	static SceneHierarchy hierarchy;
+	return hierarchy;
 }
 
-void GameObject3D::UpdateDirectionVectors()
+void GameObject3D::UpdateMatrix()
 {
-	XMMATRIX vecRotationMatrix = XMMatrixRotationRollPitchYaw(rot.x, rot.y, 0.0f);
-	vec_forward = XMVector3TransformCoord(DEFAULT_FORWARD_VECTOR, vecRotationMatrix);
-	vec_backward = XMVector3TransformCoord(DEFAULT_BACKWARD_VECTOR, vecRotationMatrix);
-	vec_left = XMVector3TransformCoord(DEFAULT_LEFT_VECTOR, vecRotationMatrix);
-	vec_right = XMVector3TransformCoord(DEFAULT_RIGHT_VECTOR, vecRotationMatrix);
-	vec_up = XMVector3TransformCoord(DEFAULT_UP_VECTOR, vecRotationMatrix);
-	vec_down = XMVector3TransformCoord(DEFAULT_DOWN_VECTOR, vecRotationMatrix);
-
-	XMMATRIX vecRotationMatrixNoY = XMMatrixRotationRollPitchYaw(0.0f, rot.y, 0.0f);
-	vec_forward_noY = XMVector3TransformCoord(DEFAULT_FORWARD_VECTOR, vecRotationMatrixNoY);
-	vec_backward_noY = XMVector3TransformCoord(DEFAULT_BACKWARD_VECTOR, vecRotationMatrixNoY);
-	vec_left_noY = XMVector3TransformCoord(DEFAULT_LEFT_VECTOR, vecRotationMatrixNoY);
-	vec_right_noY = XMVector3TransformCoord(DEFAULT_RIGHT_VECTOR, vecRotationMatrixNoY);
+	assert("UpdateMatrix must be overriden." && 0);
 }
\ No newline at end of file
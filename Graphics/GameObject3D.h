@@ -1,19 +1,23 @@
 #pragma once
 #include "GameObject.h"
 
+class SceneHierarchy;
+
 class GameObject3D : public GameObject
 {
 public:
+	~GameObject3D();
+
 	void SetLookAtPos(XMFLOAT3 lookAtPos);
-	const XMVECTOR& GetForwardVector(bool omitY = false);
-	const XMVECTOR& GetRightVector(bool omitY = false);
-	const XMVECTOR& GetBackwardVector(bool omitY = false);
-	const XMVECTOR& GetLeftVector(bool omitY = false);
-	const XMVECTOR& GetUpVector();
-	const XMVECTOR& GetDownVector();
+	XMVECTOR GetForwardVector(bool omitY = false) const;
+	XMVECTOR GetRightVector(bool omitY = false) const;
+	XMVECTOR GetBackwardVector(bool omitY = false) const;
+	XMVECTOR GetLeftVector(bool omitY = false) const;
+	XMVECTOR GetUpVector() const;
+	XMVECTOR GetDownVector() const;
 
 	// Parenting
-	void SetParent(GameObject3D* gameObject);
+	bool SetParent(GameObject3D* gameObject);
 	void SetParentOffset(const XMFLOAT3& offset);
 	void SetParentOffset(float x, float y, float z);
 	void SetParentOffset(const XMVECTOR& offset);
@@ -23,49 +27,47 @@ public:
 	void AdjustParentRotationOffset(float x, float y, float z);
 	void SetParentTracking(bool state);
 
-	const XMFLOAT3& GetParentOffset();
-	const XMVECTOR& GetParentOffsetVector();
-	const XMFLOAT3& GetParentRotationOffset();
-	const XMVECTOR& GetParentRotationOffsetVector();
-	const bool IsParentTracking();
-	GameObject3D* GetParent();
-
-	typedef std::vector<GameObject3D*> parentList;
+	const XMFLOAT3& GetParentOffset() const;
+	XMVECTOR GetParentOffsetVector() const;
+	const XMFLOAT3& GetParentRotationOffset() const;
+	XMVECTOR GetParentRotationOffsetVector() const;
+	const bool IsParentTracking() const;
+	GameObject3D* GetParent() const;
 
-	static parentList& GetParentedObjects()
-	{
-		static parentList list;
-		return list;
-	};
+	// Every parented object, the engine places them relative to their parents each frame
+	static SceneHierarchy& GetHierarchy();
 
 protected:
 	virtual void UpdateMatrix();
 
-	void UpdateDirectionVectors();
+	// Shared by every object, directions of an object are worked out from its rotation when asked for
+	static const XMVECTOR DEFAULT_FORWARD_VECTOR;
+	static const XMVECTOR DEFAULT_BACKWARD_VECTOR;
+	static const XMVECTOR DEFAULT_UP_VECTOR;
+	static const XMVECTOR DEFAULT_DOWN_VECTOR;
+	static const XMVECTOR DEFAULT_LEFT_VECTOR;
+	static const XMVECTOR DEFAULT_RIGHT_VECTOR;
 
-	const XMVECTOR DEFAULT_FORWARD_VECTOR = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
-	const XMVECTOR DEFAULT_BACKWARD_VECTOR = XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f);
-	const XMVECTOR DEFAULT_UP_VECTOR = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-	const XMVECTOR DEFAULT_DOWN_VECTOR = XMVectorSet(0.0f, -1.0f, 0.0f, 0.0f);
-	const XMVECTOR DEFAULT_LEFT_VECTOR = XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f);
-	const XMVECTOR DEFAULT_RIGHT_VECTOR = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+	bool trackParentPosition = true;
+	XMFLOAT3 parentPositionOffset = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	XMFLOAT3 parentRotationOffsetFloat3 = XMFLOAT3(0.0f, 0.0f, 0.0f);
 
-	XMVECTOR vec_forward;
-	XMVECTOR vec_left;
-	XMVECTOR vec_right;
-	XMVECTOR vec_backward;
-	XMVECTOR vec_up;
-	XMVECTOR vec_down;
+private:
+	friend class SceneHierarchy;
 
-	XMVECTOR vec_forward_noY;
-	XMVECTOR vec_left_noY;
-	XMVECTOR vec_right_noY;
-	XMVECTOR vec_backward_noY;
+	// Place in the hierarchy, a copy of an object starts out without a parent or children
+	struct SceneNode
+	{
+		SceneNode() {}
+		SceneNode(const SceneNode&) {}
+		SceneNode& operator=(const SceneNode&) { return *this; }
 
-	GameObject3D* parent = nullptr;
-	bool trackParentPosition = true;
-	XMFLOAT3 parentPositionOffset;
-	XMVECTOR parentPositionOffsetVector;
-	XMFLOAT3 parentRotationOffsetFloat3;
-	XMVECTOR parentRotationOffsetVector;
+		GameObject3D* parent = nullptr;
+		GameObject3D* firstChild = nullptr;
+		GameObject3D* nextSibling = nullptr;
+		GameObject3D* previousSibling = nullptr;
+		uint32_t depth = 0; // 0 without a parent
+		uint32_t index = 0; // Position on the level of its depth
+	};
+	SceneNode node;
 };
\ No newline at end of file
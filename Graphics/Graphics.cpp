@@ -1,4 +1,5 @@
 #include "Graphics.h"
+#include "SceneHierarchy.h"
 
 bool Graphics::Initialize(HWND hwnd, int width, int height)
 {
@@ -28,6 +29,8 @@ bool Graphics::Initialize(HWND hwnd, int width, int height)
 
 void Graphics::RenderFrame()
 {
+	PROFILE_ZONE("Graphics::RenderFrame");
+
 	// Setting constant buffers for fog
 	cb_vs_fog.data.fogStart = 1000.0f;
 	cb_vs_fog.data.fogEnd = 10000.0f;
@@ -101,55 +104,120 @@ void Graphics::RenderFrame()
 	scoreString += std::to_string(score);
 	spriteBatch->Begin();
 	spriteFont->DrawString(spriteBatch.get(), StringHelper::StringToWide(scoreString).c_str(), DirectX::XMFLOAT2(windowWidth/2 - 100, 0), DirectX::Colors::White, 0.0f, DirectX::XMFLOAT2(0.0f, 0.0f), DirectX::XMFLOAT2(2.0f, 2.0f));
+	if (gameOver)
+		spriteFont->DrawString(spriteBatch.get(), L"Game Over", DirectX::XMFLOAT2(windowWidth/2 - 100, 60), DirectX::Colors::White, 0.0f, DirectX::XMFLOAT2(0.0f, 0.0f), DirectX::XMFLOAT2(2.0f, 2.0f));
 	spriteBatch->End();
 
-	// Start the Dear ImGui frame
-	ImGui_ImplDX11_NewFrame();
-	ImGui_ImplWin32_NewFrame();
-	ImGui::NewFrame();
-	ImGui::Begin("Debug");
-	ImGui::DragFloat3("Ambient Light Color", &cb_ps_light.data.ambientLightColor.x, 0.01, 0.0f, 1.0f);
-	ImGui::DragFloat3("Ambient Light Strenght", &cb_ps_light.data.ambientLightStrenght, 0.01, 0.0f, 1.0f);
-	ImGui::NewLine();
-	ImGui::DragFloat3("Dynamic Light Position", &light.pos.x, 0.1f, -5000.0f, 5000.0f);
-	ImGui::DragFloat3("Dynamic Light Color", &light.lightColor.x, 0.01f, 0.0f, 10.0f);
-	ImGui::DragFloat3("Dynamic Specular Color", &light.dynamicSpecularColor.x, 0.01f, 0.0f, 10.0f);
-	ImGui::DragFloat("Dynamic Specular Strength", &light.dynamicSpecularPower, 1.0f, 0.0f, 800.0f);
-	ImGui::DragFloat("Dynamic Light Strength", &light.lightStrength, 0.01f, 0.0f, 10.0f);
-	ImGui::DragFloat("Dynamic Light Attenuation A", &light.attenuation_a, 0.01f, 0.1f, 10.0f);
-	ImGui::DragFloat("Dynamic Light Attenuation B", &light.attenuation_b, 0.01f, 0.0f, 10.0f);
-	ImGui::DragFloat("Dynamic Light Attenuation C", &light.attenuation_c, 0.01f, 0.0f, 10.0f);
-	ImGui::NewLine();
-	if (ImGui::Button("Free Camera"))
-		debugCameraEnabled = !debugCameraEnabled;
-	ImGui::SameLine(200);
-	if (ImGui::Button("Follow Camera"))
-		EnableThirdPersonCamera(!IsThirdPersonCameraEnabled());
-    ImGui::Text("Cam X: %f", camera.GetPositionFloat3().x);
-	ImGui::SameLine(200);
-	ImGui::Text("Cam Y: %f", camera.GetPositionFloat3().y);
-	ImGui::SameLine(400);
-	ImGui::Text("Cam Z: %f", camera.GetPositionFloat3().z);
-	ImGui::Text("Cam Rot X: %f", camera.GetRotationFloat3().x);
-	ImGui::SameLine(200);
-	ImGui::Text("Cam Rot Y: %f", camera.GetRotationFloat3().y);
-	ImGui::SameLine(400);
-	ImGui::Text("Cam Rot Z: %f", camera.GetRotationFloat3().z);
-	ImGui::Text("Character Rotation: %f", character.GetRotationFloat3().y);
-	ImGui::Text("Character Pos X: %f", character.GetPositionFloat3().x);
-	ImGui::Text("Character Pos Y: %f", character.GetPositionFloat3().y);
-	ImGui::Text("Character Pos Z: %f", character.GetPositionFloat3().z);
-	ImGui::Text(" Charecter Move Pending: %d", character.movePending);
-	ImGui::DragFloat("Character Speed", &characterSpeedModifier, 0.1f, 10, 120);
-	if (ImGui::Button("Spawm Snake Child"))
-		snake3D.CreateSnakeChild();
-	ImGui::End();
-	//Assemble Together Draw Data
-	ImGui::Render();
-	//Render Draw Data
-	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
-
-	swapchain->Present(1, NULL);   // First argument VSync
+	{
+		PROFILE_ZONE("ImGui");
+		// Start the Dear ImGui frame
+		ImGui_ImplDX11_NewFrame();
+		ImGui_ImplWin32_NewFrame();
+		ImGui::NewFrame();
+		ImGui::Begin("Debug");
+		ImGui::DragFloat3("Ambient Light Color", &cb_ps_light.data.ambientLightColor.x, 0.01, 0.0f, 1.0f);
+		ImGui::DragFloat3("Ambient Light Strenght", &cb_ps_light.data.ambientLightStrenght, 0.01, 0.0f, 1.0f);
+		ImGui::NewLine();
+		ImGui::DragFloat3("Dynamic Light Position", &light.pos.x, 0.1f, -5000.0f, 5000.0f);
+		ImGui::DragFloat3("Dynamic Light Color", &light.lightColor.x, 0.01f, 0.0f, 10.0f);
+		ImGui::DragFloat3("Dynamic Specular Color", &light.dynamicSpecularColor.x, 0.01f, 0.0f, 10.0f);
+		ImGui::DragFloat("Dynamic Specular Strength", &light.dynamicSpecularPower, 1.0f, 0.0f, 800.0f);
+		ImGui::DragFloat("Dynamic Light Strength", &light.lightStrength, 0.01f, 0.0f, 10.0f);
+		ImGui::DragFloat("Dynamic Light Attenuation A", &light.attenuation_a, 0.01f, 0.1f, 10.0f);
+		ImGui::DragFloat("Dynamic Light Attenuation B", &light.attenuation_b, 0.01f, 0.0f, 10.0f);
+		ImGui::DragFloat("Dynamic Light Attenuation C", &light.attenuation_c, 0.01f, 0.0f, 10.0f);
+		ImGui::NewLine();
+		if (ImGui::Button("Free Camera"))
+			debugCameraEnabled = !debugCameraEnabled;
+		ImGui::SameLine(200);
+		if (ImGui::Button("Follow Camera"))
+			EnableThirdPersonCamera(!IsThirdPersonCameraEnabled());
+	    ImGui::Text("Cam X: %f", camera.GetPositionFloat3().x);
+		ImGui::SameLine(200);
+		ImGui::Text("Cam Y: %f", camera.GetPositionFloat3().y);
+		ImGui::SameLine(400);
+		ImGui::Text("Cam Z: %f", camera.GetPositionFloat3().z);
+		ImGui::Text("Cam Rot X: %f", camera.GetRotationFloat3().x);
+		ImGui::SameLine(200);
+		ImGui::Text("Cam Rot Y: %f", camera.GetRotationFloat3().y);
+		ImGui::SameLine(400);
+		ImGui::Text("Cam Rot Z: %f", camera.GetRotationFloat3().z);
+		ImGui::Text("Character Rotation: %f", character.GetRotationFloat3().y);
+		ImGui::Text("Character Pos X: %f", character.GetPositionFloat3().x);
+		ImGui::Text("Character Pos Y: %f", character.GetPositionFloat3().y);
+		ImGui::Text("Character Pos Z: %f", character.GetPositionFloat3().z);
+		ImGui::Text(" Charecter Move Pending: %d", characterTurnPending);
+		ImGui::Text("Character Speed: %f", characterSpeedModifier);
+		ImGui::NewLine();
+		bool profilerEnabled = Profiler::IsEnabled();
+		if (ImGui::Checkbox("Profiler", &profilerEnabled))
+			Profiler::SetEnabled(profilerEnabled);
+		ImGui::SameLine(200);
+		if (ImGui::Button("Export Trace") && !Profiler::ExportChromeTrace("profile_trace.json"))
+			ErrorLogger::Log("Failed to export profiler trace to profile_trace.json");
+		GameObject::TransformCounters transforms = GameObject::GetTransformCounters();
+		ImGui::Text("Transform changes: %llu, rebuilds: %llu, avoided: %llu", static_cast<unsigned long long>(transforms.changes),
+			static_cast<unsigned long long>(transforms.rebuilds), static_cast<unsigned long long>(transforms.changes - transforms.rebuilds));
+		if (ImGui::Button("Memory Report"))
+		{
+			MemoryReport report;
+			ReportMemory(report);
+			OutputDebugStringA(report.ToString().c_str());
+		}
+		ImGui::End();
+		//Assemble Together Draw Data
+		ImGui::Render();
+		//Render Draw Data
+		ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+	}
+
+	{
+		PROFILE_ZONE("Present");
+		swapchain->Present(1, NULL);   // First argument VSync
+	}
+}
+
+// Every object the renderer owns by type, the snake segments and pickups grow with the game
+void Graphics::ReportMemory(MemoryReport& report)
+{
+	// Objects only hold a handle, the models they share are reported once by the registry
+	report.Add("RenderableGameObject", sizeof(RenderableGameObject), 7); // cameraRig, character, windmillBlades, snakeBody, pickupOrb, snakeTail, skybox
+	report.Add("Camera3D", sizeof(Camera3D));
+	report.Add("Light", sizeof(Light), 2);
+	report.Add("Character", sizeof(Character));
+	ModelRegistry::ReportMemory(report);
+
+	report.Add("Snake segment matrix", sizeof(SimMatrix), snakeBodyMatrices.size());
+	report.Add("Pickup position", sizeof(SimFloat3), activePickupPositions.size());
+	report.Add("Scene hierarchy entry", sizeof(GameObject3D*), GameObject3D::GetHierarchy().GetObjectCount());
+}
+
+void Graphics::UpdateFromSimulation(const SnakeSimulation& simulation, float alpha)
+{
+	/* Alpha is how far the frame is between the previous and the current simulation tick,
+	   transforms are interpolated so movement stays smooth at any tick rate */
+
+	// Character(head)
+	SnakeSegment head = SnakeSimulation::Interpolate(simulation.GetPreviousHead(), simulation.GetHead(), alpha);
+	character.SetPosition(head.position.x, head.position.y, head.position.z);
+	character.SetRotation(0.0f, head.yaw, 0.0f);
+	characterTurnPending = simulation.IsTurnPending();
+
+	// Snake body, all world matrices are built in one pass
+	const SnakeBody& body = simulation.GetBody();
+	snakeBodyMatrices.resize(body.Size());
+	body.BuildWorldMatrices(simulation.GetPreviousBody(), alpha, snakeBodyMatrices.data());
+
+	// Pickups, only the active ones are copied over
+	const std::vector<Pickup>& pickups = simulation.GetPickups();
+	const std::vector<uint32_t>& activePickups = simulation.GetActivePickups();
+	activePickupPositions.resize(activePickups.size());
+	for (size_t i = 0; i < activePickups.size(); i++)
+		activePickupPositions[i] = pickups[activePickups[i]].position;
+
+	score = simulation.GetScore();
+	characterSpeedModifier = simulation.GetSpeed();
+	gameOver = simulation.IsGameOver();
 }
 
 RenderableGameObject* Graphics::CreateGameObject(RenderableGameObject* source, std::string filePath)
@@ -358,16 +426,34 @@ bool Graphics::InitializeShaders()
 		{"BINORMAL", 0, DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA, 0}
 	};
 
+	// Positions are quantized to snorm relative to the mesh center, the mesh transform scales them back
+	DXGI_FORMAT positionFormat = (MODEL_VERTEX_FORMAT == VertexFormat::PackedQuantized) ? DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_SNORM : DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT;
+	D3D11_INPUT_ELEMENT_DESC layout_packed[] =
+	{
+		{"POSITION", 0, positionFormat, 0, 0, D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA, 0  },
+		{"TEXCOORD", 0, DXGI_FORMAT::DXGI_FORMAT_R16G16_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"NORMAL", 0, DXGI_FORMAT::DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"TANGENT", 0, DXGI_FORMAT::DXGI_FORMAT_R10G10B10A2_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA, 0}
+	};
+
 	D3D11_INPUT_ELEMENT_DESC layout_depth[] =
 	{
-		{ "POSITION", 0, DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		{ "POSITION", 0, positionFormat, 0, 0, D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA, 0 }
 	};
 
 	UINT numElements = ARRAYSIZE(layout);
 	UINT numElementsDepth = ARRAYSIZE(layout_depth);
 
-	if (!vertexshader.Initialize(device, shaderfolder + L"vertexshader.cso", layout, numElements))
-		return false;
+	if (MODEL_VERTEX_FORMAT == VertexFormat::Full)
+	{
+		if (!vertexshader.Initialize(device, shaderfolder + L"vertexshader.cso", layout, numElements))
+			return false;
+	}
+	else
+	{
+		if (!vertexshader.Initialize(device, shaderfolder + L"vertexshader_packed.cso", layout_packed, ARRAYSIZE(layout_packed)))
+			return false;
+	}
 
 	if (!pixelshader.Initialize(device, shaderfolder + L"pixelshader.cso"))
 		return false;
@@ -435,7 +521,6 @@ bool Graphics::InitializeScene()
 		// Start Game Logic
 		if (!snake3D.Initialize(device.Get(), deviceContext.Get(), cb_vs_vertexshader, &gameObjectList))
 			return false;
-		snake3D.CreateSnakeChild();
 
 		/* ******************************************** Lights ******************************************* */
 		if (!light.Initialize(device.Get(), deviceContext.Get(), cb_vs_vertexshader))
@@ -460,13 +545,10 @@ bool Graphics::InitializeScene()
 		gameObjectList.push_back(&windmillBlades);
 
 		/* ******************************************** Pickups ******************************************* */
+		// A single pickup orb is drawn at every active pickup, see RenderPickups
 		if (!pickupOrb.Initialize("Data\\Objects\\cheese.fbx", device.Get(), deviceContext.Get(), cb_vs_vertexshader))
 			return false;
 
-		// Creates the matrix for pickup orbs
-		if (!CreatePickupMatrix())
-			return false;
-
 		/* ******************************************** Character ***************************************** */
 		//if (!character2.Initialize(device.Get(), deviceContext.Get(), cb_vs_vertexshader))
 		//	return false;
@@ -485,9 +567,6 @@ bool Graphics::InitializeScene()
 		if (!snakeTail.Initialize("Data\\Objects\\Snake2\\Snake_Tail.fbx", device.Get(), deviceContext.Get(), cb_vs_vertexshader))
 			return false;
 
-		if (!CreateSnakeChild())
-			return false;
-
 		/* ******************************************** CAMERA ***************************************** */
 
 		if (!cameraRig.Initialize("Data\\Objects\\debug_orb.fbx", device.Get(), deviceContext.Get(), cb_vs_vertexshader))
@@ -512,53 +591,6 @@ bool Graphics::InitializeScene()
 	return true;
 }
 
-bool Graphics::CreateSnakeChild()
-{	
-	size_t numChilds = snakeBodyList.size();
-	
-	/* If list is empty it will just create a tail object
-	   When its not empty it will add a tail object and replace the next childs model
-	   with the middle body */
-	if (!snakeBodyList.empty())
-	{
-		RenderableGameObject* snakeTail = CreateGameObject(&this->snakeTail);
-		if (snakeTail == nullptr)
-			return false;
-		// Find position of parent in order to spawm child at correction position and orientation
-		snakeTail->SetParentTracking(false);
-		snakeTail->SetParent(snakeBodyList.at(numChilds - 1));		
-		snakeTail->SetPosition(snakeTail->GetParent()->GetPositionFloat3());
-		gameObjectList.push_back(snakeTail);
-		snakeBodyList.push_back(snakeTail);
-
-		// Set previous child to middle body
-		
-		snakeBodyList.at(numChilds - 1)->SetModel(snakeBody.GetModel());
-		snakeBodyList.at(numChilds - 1)->SetWorldMatrix(snakeBody.GetWorldMatrix());
-	}
-	else
-	{
-		// Set tail
-		RenderableGameObject* snakeTail = CreateGameObject(&this->snakeTail);
-		if (snakeTail == nullptr)
-			return false;
-		snakeTail->SetPosition(0.0f, 36.0f, -73.0f);
-		snakeTail->SetParentTracking(false);
-		snakeTail->SetParent(&character);	
-		gameObjectList.push_back(snakeTail);
-		snakeBodyList.push_back(snakeTail);
-	}
-	return true;
-}
-
-void Graphics::SpawnPickup()
-{
-	size_t i = rand() % pickupOrbList.size();
-	if (pickupOrbList.at(i)->IsVisible())
-		SpawnPickup();
-	pickupOrbList.at(i)->SetVisible(true);
-}
-
 void Graphics::EnableThirdPersonCamera(const bool& state)
 {
 	if (state)
@@ -579,35 +611,41 @@ bool Graphics::IsThirdPersonCameraEnabled()
 	return thirdPersonCameraEnabled;
 }
 
-bool Graphics::CreatePickupMatrix()
+void Graphics::Render(RenderableGameObject* gameObject, const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix,
+	                  ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2)
 {
-	// Set X/Z axis array
-	for (size_t i = 0; i < 23; i++)
+	gameObject->Draw(viewMatrix, projectionMatrix, shaderResource, shaderResource2);
+}
+
+/* Draws one model per matrix, the last segment is drawn as the tail */
+void Graphics::RenderSnakeBody(const std::vector<SimMatrix>& matrices, RenderableGameObject* middle, RenderableGameObject* tail,
+	                           const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix,
+	                           ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2)
+{
+	for (size_t i = 0; i < matrices.size(); i++)
 	{
-		for (size_t j = 0; j < 24; j++)
-		{
-			RenderableGameObject* _pickupOrb = CreateGameObject(&pickupOrb);
-			if (_pickupOrb == nullptr)
-				return false;
-
-			_pickupOrb->SetVisible(false);
-			_pickupOrb->SetPosition(-930.0f + (80.0f * j), 5, 930.0f + (-85.0f * i));
-			pickupOrbList.push_back(_pickupOrb);
-			gameObjectList.push_back(_pickupOrb);
-		}
+		RenderableGameObject* segment = (i + 1 == matrices.size()) ? tail : middle;
+		// SimMatrix has the same layout as XMFLOAT4X4
+		XMMATRIX worldMatrix = XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(&matrices[i]));
+		segment->Draw(worldMatrix, viewMatrix, projectionMatrix, shaderResource, shaderResource2);
 	}
-
-	return true;
 }
 
-void Graphics::Render(RenderableGameObject* gameObject, const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix,
-	                  ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2)
+/* Draws the pickup orb once at every active pickup, hidden pickups are never visited */
+void Graphics::RenderPickups(const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix,
+	                         ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2)
 {
-	gameObject->Draw(viewMatrix, projectionMatrix, shaderResource, shaderResource2);
+	for (size_t i = 0; i < activePickupPositions.size(); i++)
+	{
+		const SimFloat3& position = activePickupPositions[i];
+		pickupOrb.Draw(XMMatrixTranslation(position.x, position.y, position.z), viewMatrix, projectionMatrix, shaderResource, shaderResource2);
+	}
 }
 
 void Graphics::RenderDepthBuffer()
 {
+	PROFILE_ZONE("Graphics::RenderDepthBuffer");
+
 	{
 		// Setting shaders to depth mode
 		deviceContext->VSSetShader(depthVertexShader.GetShader(), NULL, 0);
@@ -632,11 +670,17 @@ void Graphics::RenderDepthBuffer()
 			cb_vs_depth.data.worldMatrix = cb_vs_vertexshader.data.worldMatrix;
 			cb_vs_depth.ApplyChanges();
 		}
+
+		// Snake bodies are drawn straight from their world matrices
+		RenderSnakeBody(snakeBodyMatrices, &snakeBody, &snakeTail, light.GetViewMatrix(), light.GetProjectionMatrix(), renderTexture.GetShaderResourceView(), skyboxTexture.GetResourceView());
+		RenderPickups(light.GetViewMatrix(), light.GetProjectionMatrix(), renderTexture.GetShaderResourceView(), skyboxTexture.GetResourceView());
 	}
 }
 
 void Graphics::RenderSkybox()
 {
+	PROFILE_ZONE("Graphics::RenderSkybox");
+
 	// Setting rending target and view to default camera
 	deviceContext->OMSetRenderTargets(1, renderTargetView.GetAddressOf(), depthStencilView.Get());
 	CD3D11_VIEWPORT viewport(0.0f, 0.0f, static_cast<float>(windowWidth), static_cast<float>(windowHeight));;
@@ -656,6 +700,8 @@ void Graphics::RenderSkybox()
 
 void Graphics::RenderScene()
 {
+	PROFILE_ZONE("Graphics::RenderScene");
+
 	deviceContext->RSSetState(rasterizerState.Get());
 	deviceContext->OMSetDepthStencilState(depthStencilState.Get(), 0);
 	deviceContext->IASetInputLayout(vertexshader.GetInputLayout());
@@ -671,6 +717,9 @@ void Graphics::RenderScene()
 			Render(gameObjectList.at(i), camera.GetViewMatrix(), camera.GetProjectionMatrix(), renderTexture.GetShaderResourceView(), skyboxTexture.GetResourceView());
 		}
 
+		RenderSnakeBody(snakeBodyMatrices, &snakeBody, &snakeTail, camera.GetViewMatrix(), camera.GetProjectionMatrix(), renderTexture.GetShaderResourceView(), skyboxTexture.GetResourceView());
+		RenderPickups(camera.GetViewMatrix(), camera.GetProjectionMatrix(), renderTexture.GetShaderResourceView(), skyboxTexture.GetResourceView());
+
 		{
 			//deviceContext->PSSetShader(pixelshader_nolight.GetShader(), NULL, 0);
 			//Render(&light, camera.GetViewMatrix(), camera.GetProjectionMatrix(), renderTexture.GetShaderResourceView(), skyboxTexture.GetResourceView());
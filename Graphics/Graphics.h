@@ -14,13 +14,18 @@
 #include "..\\Game\Snake3D.h"
 #include "RenderTextureClass.h"
 #include "CubeTexture.h"
+#include "..\\Simulation\SnakeSimulation.h"
+#include "..\\Profiler\Profiler.h"
+#include "..\\Profiler\MemoryReport.h"
 
 class Graphics
 {
 public:
 	bool Initialize(HWND hwnd, int width, int height);
 	void RenderFrame();
+	void UpdateFromSimulation(const SnakeSimulation& simulation, float alpha = 1.0f);
 	RenderableGameObject* CreateGameObject(RenderableGameObject* source = nullptr, std::string filePath = "");
+	void ReportMemory(MemoryReport& report);
 
 	Camera3D camera;
 	RenderableGameObject cameraRig;
@@ -32,13 +37,13 @@ public:
 
 	RenderableGameObject character;
 	RenderableGameObject windmillBlades;
-	std::vector<RenderableGameObject*> snakeBodyList;
+	std::vector<SimMatrix> snakeBodyMatrices; // World matrix of every body segment, built by the simulation
 	std::vector<RenderableGameObject*> gameObjectList;
-	std::vector<RenderableGameObject*> pickupOrbList;
+	std::vector<SimFloat3> activePickupPositions; // Only the pickups that are visible, copied from the simulation
 	float characterSpeedModifier = 20.0f;
+	bool characterTurnPending = false;
 	int score = 0;
-	bool CreateSnakeChild();
-	void SpawnPickup();
+	bool gameOver = false;
 	void EnableThirdPersonCamera(const bool& state);
 	bool IsThirdPersonCameraEnabled();
 
@@ -46,9 +51,13 @@ private:
 	bool InitializeDirectX(HWND hwnd);
 	bool InitializeShaders();
 	bool InitializeScene();
-	bool CreatePickupMatrix();
 	void Render(RenderableGameObject* gameObject, const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix,
 		        ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2);
+	void RenderSnakeBody(const std::vector<SimMatrix>& matrices, RenderableGameObject* middle, RenderableGameObject* tail,
+		                 const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix,
+		                 ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2);
+	void RenderPickups(const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix,
+		               ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2);
 
 	void RenderDepthBuffer();
 	void RenderSkybox();
@@ -12,6 +12,7 @@ private:
 private:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
 	UINT indexCount = 0;
+	DXGI_FORMAT format = DXGI_FORMAT_R32_UINT;
 public:
 	IndexBuffer() {}
 
@@ -30,23 +31,48 @@ public:
 		return this->indexCount;
 	}
 
-	HRESULT Initialize(ID3D11Device* device, DWORD* data, UINT indexCount)
+	DXGI_FORMAT Format() const
+	{
+		return this->format;
+	}
+
+	// Indices are stored as 16 bit when every one of them fits, halving the buffer
+	HRESULT Initialize(ID3D11Device* device, const DWORD* data, UINT indexCount)
 	{
 		if (buffer.Get() != nullptr)
 			buffer.Reset();
 
 		this->indexCount = indexCount;
+
+		DWORD maxIndex = 0;
+		for (UINT i = 0; i < indexCount; i++)
+			maxIndex = (data[i] > maxIndex) ? data[i] : maxIndex;
+
+		std::vector<uint16_t> shortIndices;
+		const void* indexData = data;
+		UINT indexSize = sizeof(DWORD);
+		this->format = DXGI_FORMAT_R32_UINT;
+		if (maxIndex <= 0xFFFF)
+		{
+			shortIndices.resize(indexCount);
+			for (UINT i = 0; i < indexCount; i++)
+				shortIndices[i] = static_cast<uint16_t>(data[i]);
+			indexData = shortIndices.data();
+			indexSize = sizeof(uint16_t);
+			this->format = DXGI_FORMAT_R16_UINT;
+		}
+
 		//Load Index Data
 		D3D11_BUFFER_DESC indexBufferDesc;
 		ZeroMemory(&indexBufferDesc, sizeof(indexBufferDesc));
 		indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		indexBufferDesc.ByteWidth = sizeof(DWORD) * indexCount;
+		indexBufferDesc.ByteWidth = indexSize * indexCount;
 		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 		indexBufferDesc.CPUAccessFlags = 0;
 		indexBufferDesc.MiscFlags = 0;
 
 		D3D11_SUBRESOURCE_DATA indexBufferData;
-		indexBufferData.pSysMem = data;
+		indexBufferData.pSysMem = indexData;
 		HRESULT hr = device->CreateBuffer(&indexBufferDesc, &indexBufferData, buffer.GetAddressOf());
 		return hr;
 	}
@@ -2,17 +2,18 @@
 
 bool Light::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext, ConstantBuffer<CB_VS_vertexshader>& cb_vs_vertexshader)
 {
-	if (!model.Initialize("Data/Objects/light.fbx", device, deviceContext, cb_vs_vertexshader))
+	if (!RenderableGameObject::Initialize("Data/Objects/light.fbx", device, deviceContext, cb_vs_vertexshader))
 		return false;
 
 	SetPosition(0.0f, 0.0f, 0.0f);
 	SetRotation(0.0f, 0.0f, 0.0f);
-	UpdateMatrix();
+	UpdateTransform();
 	return true;
 }
 
 void Light::UpdateMatrix() //Updates view matrix and also updates the movement vectors
 {
+	XMVECTOR posVector = XMLoadFloat3(&pos);
 	//Calculate Camera3D rotation matrix
 	XMMATRIX camRotationMatrix = XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z);
 	//Calculate unit vector of cam target based off Camera3D forward value transformed by cam rotation matrix
@@ -25,8 +26,6 @@ void Light::UpdateMatrix() //Updates view matrix and also updates the movement v
 	viewMatrix = XMMatrixLookAtLH(posVector, camTarget, upDir);
 
 	worldMatrix = XMMatrixScaling(scale.x, scale.y, scale.z) * XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z) * XMMatrixTranslation(pos.x, pos.y, pos.z);
-
-	UpdateDirectionVectors();
 }
 
 void Light::SetProjectionValues(float fovDegrees, float aspectRatio, float nearZ, float farZ)
@@ -35,8 +34,9 @@ void Light::SetProjectionValues(float fovDegrees, float aspectRatio, float nearZ
 	projectionMatrix = XMMatrixPerspectiveFovLH(fovRadians, aspectRatio, nearZ, farZ);
 }
 
-const XMMATRIX& Light::GetViewMatrix() const
+const XMMATRIX& Light::GetViewMatrix()
 {
+	UpdateTransform();
 	return viewMatrix;
 }
 
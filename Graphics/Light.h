@@ -9,7 +9,7 @@ public:
 
 	void SetProjectionValues(float fovDegrees, float aspectRatio, float nearZ, float farZ);
 
-	const XMMATRIX& GetViewMatrix() const;
+	const XMMATRIX& GetViewMatrix();
 	const XMMATRIX& GetProjectionMatrix() const;
 
 	DirectX::XMFLOAT3 lightColor = DirectX::XMFLOAT3(0.89f, 0.790f, 0.950f);
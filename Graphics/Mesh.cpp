@@ -1,15 +1,45 @@
 #include "Mesh.h"
+#include "..\\Assets\VertexPacking.h"
 
-Mesh::Mesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, std::vector<Vertex>& vertices, std::vector<DWORD>& indices, std::vector<Texture> & textures, const DirectX::XMMATRIX& transformMatrix)
+static_assert(sizeof(DWORD) == sizeof(uint32_t), "Index buffers are filled straight from uint32_t indices");
+
+// Vertices and indices are only read while the buffers are created, they can point into a mapped file
+Mesh::Mesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, const Vertex* vertices, UINT vertexCount, const DWORD* indices, UINT indexCount, const std::vector<Texture>& textures, const DirectX::XMMATRIX& transformMatrix)
 {
 	this->deviceContext = deviceContext;
 	this->textures = textures;
 	this->transformMatrix = transformMatrix;
 
-	HRESULT hr = vertexbuffer.Initialize(device, vertices.data(), vertices.size());
+	HRESULT hr = S_OK;
+	switch (MODEL_VERTEX_FORMAT)
+	{
+	case VertexFormat::Packed:
+	{
+		std::vector<PackedVertex> packed(vertexCount);
+		for (UINT i = 0; i < vertexCount; i++)
+			packed[i] = VertexPacking::Pack(vertices[i]);
+		hr = packedVertexbuffer.Initialize(device, packed.data(), vertexCount);
+		break;
+	}
+	case VertexFormat::PackedQuantized:
+	{
+		// The shaders take the quantized positions as they are, the mesh transform scales them back
+		PositionQuantization quantization = VertexPacking::GetQuantization(vertices, vertexCount);
+		std::vector<QuantizedVertex> quantized(vertexCount);
+		for (UINT i = 0; i < vertexCount; i++)
+			quantized[i] = VertexPacking::Quantize(vertices[i], quantization);
+		hr = quantizedVertexbuffer.Initialize(device, quantized.data(), vertexCount);
+		this->transformMatrix = DirectX::XMMatrixScaling(quantization.scale, quantization.scale, quantization.scale) *
+			DirectX::XMMatrixTranslation(quantization.center.x, quantization.center.y, quantization.center.z) * transformMatrix;
+		break;
+	}
+	default:
+		hr = vertexbuffer.Initialize(device, vertices, vertexCount);
+		break;
+	}
 	COM_ERROR_IF_FAILED(hr, "Failed to initialize vertex buffer for mesh.");
 
-	hr = indexbuffer.Initialize(device, indices.data(), indices.size());
+	hr = indexbuffer.Initialize(device, indices, indexCount);
 	COM_ERROR_IF_FAILED(hr, "Failed to initialize index buffer for mesh.");
 }
 
@@ -18,14 +48,14 @@ Mesh::Mesh(const Mesh& mesh)
 	deviceContext = mesh.deviceContext;
 	indexbuffer = mesh.indexbuffer;
 	vertexbuffer = mesh.vertexbuffer;
+	packedVertexbuffer = mesh.packedVertexbuffer;
+	quantizedVertexbuffer = mesh.quantizedVertexbuffer;
 	textures = mesh.textures;
 	transformMatrix = mesh.transformMatrix;
 }
 
-void Mesh::Draw(ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2, ConstantBuffer<CB_VS_vertexshader>* cb_vs_vertexshader)
+void Mesh::Draw(ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2, ConstantBuffer<CB_VS_vertexshader>* cb_vs_vertexshader) const
 {
-	UINT offset = 0;
-
 	ID3D11ShaderResourceView* textureBuf[4] = { nullptr, nullptr, nullptr, nullptr };
 
 	cb_vs_vertexshader->data.isNormalEnabled = 0;
@@ -67,12 +97,29 @@ void Mesh::Draw(ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceVi
 	deviceContext->PSSetShaderResources(3, 3, textureBuf);
 
 	// Sets vertex and index buffers then draws the mesh
-	deviceContext->IASetVertexBuffers(0, 1, vertexbuffer.GetAddressOf(), vertexbuffer.StridePtr(), &offset);
-	deviceContext->IASetIndexBuffer(indexbuffer.Get(), DXGI_FORMAT::DXGI_FORMAT_R32_UINT, 0);
+	SetVertexBuffer();
+	deviceContext->IASetIndexBuffer(indexbuffer.Get(), indexbuffer.Format(), 0);
 	deviceContext->DrawIndexed(indexbuffer.IndexCount(), 0, 0);
 }
 
-const DirectX::XMMATRIX& Mesh::GetTransformMatrix()
+const DirectX::XMMATRIX& Mesh::GetTransformMatrix() const
 {
 	return transformMatrix;
 }
+
+void Mesh::SetVertexBuffer() const
+{
+	UINT offset = 0;
+	switch (MODEL_VERTEX_FORMAT)
+	{
+	case VertexFormat::Packed:
+		deviceContext->IASetVertexBuffers(0, 1, packedVertexbuffer.GetAddressOf(), packedVertexbuffer.StridePtr(), &offset);
+		break;
+	case VertexFormat::PackedQuantized:
+		deviceContext->IASetVertexBuffers(0, 1, quantizedVertexbuffer.GetAddressOf(), quantizedVertexbuffer.StridePtr(), &offset);
+		break;
+	default:
+		deviceContext->IASetVertexBuffers(0, 1, vertexbuffer.GetAddressOf(), vertexbuffer.StridePtr(), &offset);
+		break;
+	}
+}
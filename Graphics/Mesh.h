@@ -3,21 +3,24 @@
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
 #include "ConstantBuffer.h"
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include "Texture.h"
 
 class Mesh
 {
 public:
-	Mesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, std::vector<Vertex>& vertices, std::vector<DWORD>& indices, std::vector<Texture> & textures, const DirectX::XMMATRIX & transformMatrix);
+	Mesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, const Vertex* vertices, UINT vertexCount, const DWORD* indices, UINT indexCount, const std::vector<Texture>& textures, const DirectX::XMMATRIX& transformMatrix);
 	Mesh(const Mesh& mesh);
-	void Draw(ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2, ConstantBuffer<CB_VS_vertexshader>* cb_vs_vertexshader);
-	const DirectX::XMMATRIX& GetTransformMatrix();
+	void Draw(ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2, ConstantBuffer<CB_VS_vertexshader>* cb_vs_vertexshader) const;
+	const DirectX::XMMATRIX& GetTransformMatrix() const;
 
 private:
+	void SetVertexBuffer() const;
+
+	// Only the buffer of MODEL_VERTEX_FORMAT is created
 	VertexBuffer<Vertex> vertexbuffer;
+	VertexBuffer<PackedVertex> packedVertexbuffer;
+	VertexBuffer<QuantizedVertex> quantizedVertexbuffer;
 	IndexBuffer indexbuffer;
 	ID3D11DeviceContext* deviceContext;
 	std::vector<Texture> textures;
@@ -1,27 +1,30 @@
 #pragma once
 #include "Mesh.h"
+#include "..\\Assets\CookedMesh.h"
 
 using namespace DirectX;
 
 class Model
 {
 public:
+	Model() {}
+
 	bool Initialize(const std::string& filePath, ID3D11Device* device, ID3D11DeviceContext* deviceContext, ConstantBuffer<CB_VS_vertexshader>& cb_vs_vertexshader);
 	void Draw(const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix,
-		      ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2);
+		      ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2) const;
+	size_t GetMemoryUsage() const;
 
 private:
+	// Models are shared through the ModelRegistry, never copied
+	Model(const Model&) = delete;
+	Model& operator=(const Model&) = delete;
+
 	std::vector<Mesh> meshes;
 	static std::vector<Texture> loadedTextures;
 	bool LoadModel(const std::string& filePath);
-	void ProcessNode(aiNode* node, const aiScene* scene, const XMMATRIX & parentTransformMatrix);
-	Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene, const XMMATRIX& transformMatrix);
-	void CalculateTangentBinormal(Vertex vertex1, Vertex vertex2, Vertex vertex3,
-		XMFLOAT3& tangent, XMFLOAT3& binormal);
-	void CalculateNormal(XMFLOAT3 tangent, XMFLOAT3 binormal, XMFLOAT3& normal);
-	TextureStorageType DetermineTextureStorageType(const aiScene* pScene, aiMaterial* pMat, unsigned int index, aiTextureType textureType);
-	std::vector<Texture> LoadMaterialTextures(aiMaterial* pMaterial, aiTextureType textureType, const aiScene* pScene);
-	int GetTextureIndex(aiString* pStr);
+	bool LoadCooked(const CookedMeshFile& cooked);
+	bool LoadImported(const ModelData& model);
+	Texture CreateTexture(aiTextureType type, TextureSource source, const std::string& name, const uint8_t* data, size_t size);
 
 	ID3D11Device* device = nullptr;
 	ID3D11DeviceContext* deviceContext = nullptr;
@@ -0,0 +1,56 @@
+#include "ModelRegistry.h"
+#include <algorithm>
+
+std::unordered_map<std::string, std::weak_ptr<const Model>> ModelRegistry::models;
+
+// "Data/a.fbx" and "Data\\a.fbx" are the same file
+static std::string GetKey(const std::string& filePath)
+{
+	std::string key = filePath;
+	std::replace(key.begin(), key.end(), '/', '\\');
+	return key;
+}
+
+// The model of the file, loaded only if no object uses it yet. Empty if the file could not be loaded
+ModelHandle ModelRegistry::Load(const std::string& filePath, ID3D11Device* device, ID3D11DeviceContext* deviceContext, ConstantBuffer<CB_VS_vertexshader>& cb_vs_vertexshader)
+{
+	std::string key = GetKey(filePath);
+	std::unordered_map<std::string, std::weak_ptr<const Model>>::iterator it = models.find(key);
+	if (it != models.end())
+	{
+		ModelHandle model = it->second.lock();
+		if (model != nullptr)
+			return model;
+	}
+
+	std::shared_ptr<Model> model = std::make_shared<Model>();
+	if (!model->Initialize(filePath, device, deviceContext, cb_vs_vertexshader))
+		return ModelHandle();
+
+	models[key] = model;
+	return model;
+}
+
+// Models that are still in use
+size_t ModelRegistry::GetModelCount()
+{
+	size_t count = 0;
+	std::unordered_map<std::string, std::weak_ptr<const Model>>::const_iterator it;
+	for (it = models.begin(); it != models.end(); ++it)
+	{
+		if (!it->second.expired())
+			count++;
+	}
+	return count;
+}
+
+void ModelRegistry::ReportMemory(MemoryReport& report)
+{
+	std::unordered_map<std::string, std::weak_ptr<const Model>>::const_iterator it;
+	for (it = models.begin(); it != models.end(); ++it)
+	{
+		ModelHandle model = it->second.lock();
+		if (model != nullptr)
+			report.Add("Model", sizeof(Model), 1, model->GetMemoryUsage());
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Model.h"
+#include "..\\Profiler\MemoryReport.h"
+
+// Shared, read only model, the model is freed when the last handle to it is gone
+typedef std::shared_ptr<const Model> ModelHandle;
+
+/* Loads every model file once and hands out handles to it.
+*
+*  Objects drawing the same file share one Model, so adding objects costs a handle and not a
+*  copy of the meshes and textures. The registry only keeps weak references, a model lives as
+*  long as an object uses it and is read from disk again if it is needed after that. */
+class ModelRegistry
+{
+public:
+	static ModelHandle Load(const std::string& filePath, ID3D11Device* device, ID3D11DeviceContext* deviceContext, ConstantBuffer<CB_VS_vertexshader>& cb_vs_vertexshader);
+	static size_t GetModelCount();
+	static void ReportMemory(MemoryReport& report);
+
+private:
+	static std::unordered_map<std::string, std::weak_ptr<const Model>> models; // By file path
+};
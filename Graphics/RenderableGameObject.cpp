@@ -2,10 +2,11 @@
 
 bool RenderableGameObject::Initialize(const std::string& filePath, ID3D11Device* device, ID3D11DeviceContext* deviceContext, ConstantBuffer<CB_VS_vertexshader>& cb_vs_vertexshader)
 {
-	if (!model.Initialize(filePath, device, deviceContext, cb_vs_vertexshader))
+	model = ModelRegistry::Load(filePath, device, deviceContext, cb_vs_vertexshader);
+	if (model == nullptr)
 		return false;
 
-	UpdateMatrix();
+	UpdateTransform();
 	return true;
 }
 
@@ -20,10 +21,19 @@ RenderableGameObject::RenderableGameObject()
 
 void RenderableGameObject::Draw(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2)
 {
-	model.Draw(worldMatrix, viewMatrix, projectionMatrix, shaderResource, shaderResource2);
+	UpdateTransform();
+	if (model != nullptr)
+		model->Draw(worldMatrix, viewMatrix, projectionMatrix, shaderResource, shaderResource2);
 }
 
-void RenderableGameObject::SetModel(const Model& model)
+// Draws the model at another world matrix, used to draw many copies of one object
+void RenderableGameObject::Draw(const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2)
+{
+	if (model != nullptr)
+		model->Draw(worldMatrix, viewMatrix, projectionMatrix, shaderResource, shaderResource2);
+}
+
+void RenderableGameObject::SetModel(const ModelHandle& model)
 {
 	this->model = model;
 }
@@ -31,16 +41,17 @@ void RenderableGameObject::SetModel(const Model& model)
 void RenderableGameObject::SetWorldMatrix(const XMMATRIX& worldMatrix)
 {
 	this->worldMatrix = worldMatrix;
-	UpdateMatrix();
+	MarkTransformDirty();
 }
 
-Model RenderableGameObject::GetModel()
+const ModelHandle& RenderableGameObject::GetModel() const
 {
 	return model;
 }
 
 XMMATRIX RenderableGameObject::GetWorldMatrix()
 {
+	UpdateTransform();
 	return worldMatrix;
 }
 
@@ -57,5 +68,4 @@ void RenderableGameObject::SetVisible(const bool& state)
 void RenderableGameObject::UpdateMatrix()
 {
 	worldMatrix = XMMatrixScaling(scale.x, scale.y, scale.z) * XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z) * XMMatrixTranslation(pos.x, pos.y, pos.z);
-	UpdateDirectionVectors();
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "GameObject3D.h"
+#include "ModelRegistry.h"
 
 class RenderableGameObject : public GameObject3D
 {
@@ -8,16 +9,17 @@ public:
 	RenderableGameObject();
 
 	void Draw(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2);
-	void SetModel(const Model& model);
+	void Draw(const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, ID3D11ShaderResourceView* shaderResource, ID3D11ShaderResourceView* shaderResource2);
+	void SetModel(const ModelHandle& model);
 	void SetWorldMatrix(const XMMATRIX& worldMatrix);
-	Model GetModel();
+	const ModelHandle& GetModel() const;
 	XMMATRIX GetWorldMatrix();
 
 	bool IsVisible();
 	void SetVisible(const bool& state);
 	
 protected:
-	Model model;
+	ModelHandle model; // Shared with every object using the same file
 	void UpdateMatrix() override;
 
 	XMMATRIX worldMatrix = XMMatrixIdentity();
@@ -0,0 +1,178 @@
+#include "SceneHierarchy.h"
+#include "GameObject3D.h"
+
+// Moves the object to its parent with the offsets added, only the position and rotation of the parent are read
+static void Place(GameObject3D* object)
+{
+	if (!object->IsParentTracking())
+		return;
+
+	const GameObject3D* parent = object->GetParent();
+	object->SetPosition(parent->GetPositionVector() + (
+		(parent->GetForwardVector() * object->GetParentOffset().x) +
+		(parent->GetUpVector() * object->GetParentOffset().y) +
+		(parent->GetRightVector() * object->GetParentOffset().z)));
+
+	object->SetRotation(parent->GetRotationVector() + object->GetParentRotationOffsetVector());
+}
+
+/* Parents the object, its children come along and keep their parents.
+*  Fails when the object would end up as its own ancestor */
+bool SceneHierarchy::Attach(GameObject3D* object, GameObject3D* parent)
+{
+	if (object == nullptr || parent == nullptr)
+		return false;
+
+	for (GameObject3D* ancestor = parent; ancestor != nullptr; ancestor = ancestor->node.parent)
+	{
+		if (ancestor == object)
+			return false;
+	}
+
+	if (object->node.parent == parent)
+		return true;
+
+	if (object->node.parent != nullptr)
+	{
+		Unlink(object);
+		Erase(object);
+	}
+
+	Link(object, parent);
+	Insert(object, parent->node.depth + 1);
+	MoveChildren(object);
+	return true;
+}
+
+// The object becomes a root, its children stay attached to it
+void SceneHierarchy::Detach(GameObject3D* object)
+{
+	if (object == nullptr || object->node.parent == nullptr)
+		return;
+
+	Unlink(object);
+	Erase(object);
+	MoveChildren(object);
+}
+
+// Takes the object out completely, its children become roots. Used when the object is destroyed
+void SceneHierarchy::Remove(GameObject3D* object)
+{
+	if (object == nullptr)
+		return;
+
+	Detach(object);
+	while (object->node.firstChild != nullptr)
+		Detach(object->node.firstChild);
+}
+
+// Places every parented object relative to its parent, one level after the other
+void SceneHierarchy::Update()
+{
+	PROFILE_ZONE("SceneHierarchy::Update");
+
+	if (objectCount == 0)
+		return;
+
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		std::vector<GameObject3D*>& level = levels[i];
+		// Below the threshold waking the workers costs more than the work
+		if (workers == nullptr || level.size() < HIERARCHY_PARALLEL_THRESHOLD)
+			PlaceChunk(&level, 0, level.size());
+		else
+			workers->ParallelFor(level.size(), HIERARCHY_CHUNK_SIZE, PlaceChunk, &level);
+	}
+}
+
+void SceneHierarchy::SetWorkerPool(WorkerPool* workers)
+{
+	this->workers = workers;
+}
+
+size_t SceneHierarchy::GetObjectCount() const
+{
+	return objectCount;
+}
+
+// Levels can be left empty after objects were detached, they are skipped by the update
+size_t SceneHierarchy::GetLevelCount() const
+{
+	return levels.size();
+}
+
+const std::vector<GameObject3D*>& SceneHierarchy::GetLevel(size_t level) const
+{
+	return levels.at(level);
+}
+
+// Puts the object in front of the children of the parent
+void SceneHierarchy::Link(GameObject3D* object, GameObject3D* parent)
+{
+	GameObject3D::SceneNode& node = object->node;
+	node.parent = parent;
+	node.previousSibling = nullptr;
+	node.nextSibling = parent->node.firstChild;
+	if (node.nextSibling != nullptr)
+		node.nextSibling->node.previousSibling = object;
+	parent->node.firstChild = object;
+}
+
+void SceneHierarchy::Unlink(GameObject3D* object)
+{
+	GameObject3D::SceneNode& node = object->node;
+	if (node.previousSibling != nullptr)
+		node.previousSibling->node.nextSibling = node.nextSibling;
+	else
+		node.parent->node.firstChild = node.nextSibling;
+	if (node.nextSibling != nullptr)
+		node.nextSibling->node.previousSibling = node.previousSibling;
+
+	node.parent = nullptr;
+	node.nextSibling = nullptr;
+	node.previousSibling = nullptr;
+}
+
+void SceneHierarchy::Insert(GameObject3D* object, uint32_t depth)
+{
+	if (levels.size() < depth)
+		levels.resize(depth);
+
+	std::vector<GameObject3D*>& level = levels[depth - 1];
+	object->node.depth = depth;
+	object->node.index = static_cast<uint32_t>(level.size());
+	level.push_back(object);
+	objectCount++;
+}
+
+// Fills the place of the object with the last object of its level
+void SceneHierarchy::Erase(GameObject3D* object)
+{
+	std::vector<GameObject3D*>& level = levels[object->node.depth - 1];
+	GameObject3D* last = level.back();
+	level[object->node.index] = last;
+	last->node.index = object->node.index;
+	level.pop_back();
+
+	object->node.depth = 0;
+	object->node.index = 0;
+	objectCount--;
+}
+
+// Puts the children one level below the object again after its depth changed, and their children after them
+void SceneHierarchy::MoveChildren(GameObject3D* object)
+{
+	for (GameObject3D* child = object->node.firstChild; child != nullptr; child = child->node.nextSibling)
+	{
+		Erase(child);
+		Insert(child, object->node.depth + 1);
+		MoveChildren(child);
+	}
+}
+
+void SceneHierarchy::PlaceChunk(void* context, size_t begin, size_t end)
+{
+	std::vector<GameObject3D*>& level = *static_cast<std::vector<GameObject3D*>*>(context);
+	for (size_t i = begin; i < end; i++)
+		Place(level[i]);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "..\\Profiler\Profiler.h"
+#include "..\\Threading\WorkerPool.h"
+
+class GameObject3D;
+
+constexpr size_t HIERARCHY_PARALLEL_THRESHOLD = 1024; // Objects on one level before the level is split across the workers
+constexpr size_t HIERARCHY_CHUNK_SIZE = 256;
+
+/* Parented objects sorted by depth, level 0 holds the children of objects that have no parent.
+*
+*  Every object knows its level and its index in it, so attaching or detaching an object without
+*  children is a push or a swap with the last object of the level. An object with children takes
+*  its whole subtree along to the new depth. Update goes through the levels in order, so a parent
+*  is always placed before its children in the same frame. Objects of one level only read their
+*  parents, which are done already, and a large level is placed in parallel. */
+class SceneHierarchy
+{
+public:
+	bool Attach(GameObject3D* object, GameObject3D* parent);
+	void Detach(GameObject3D* object);
+	void Remove(GameObject3D* object);
+
+	void Update();
+	void SetWorkerPool(WorkerPool* workers);
+
+	size_t GetObjectCount() const;
+	size_t GetLevelCount() const;
+	const std::vector<GameObject3D*>& GetLevel(size_t level) const;
+
+private:
+	void Link(GameObject3D* object, GameObject3D* parent);
+	void Unlink(GameObject3D* object);
+	void Insert(GameObject3D* object, uint32_t depth);
+	void Erase(GameObject3D* object);
+	void MoveChildren(GameObject3D* object);
+
+	static void PlaceChunk(void* context, size_t begin, size_t end);
+
+	std::vector<std::vector<GameObject3D*>> levels; // Level n holds the objects at depth n + 1
+	size_t objectCount = 0;
+	WorkerPool* workers = nullptr;
+};
@@ -49,7 +49,7 @@ Texture::Texture(ID3D11Device* device, const uint8_t* pData, size_t size, aiText
 	COM_ERROR_IF_FAILED(hr, "Failed to create Texture from memory.");
 }
 
-aiTextureType Texture::GetType()
+aiTextureType Texture::GetType() const
 {
 	return this->type;
 }
@@ -64,7 +64,7 @@ void Texture::SetName(const aiString& name)
 	this->name = name;
 }
 
-ID3D11ShaderResourceView* Texture::GetTextureResourceView()
+ID3D11ShaderResourceView* Texture::GetTextureResourceView() const
 {
 	return this->textureView.Get();
 }
@@ -6,17 +6,6 @@
 #include <WICTextureLoader.h>
 #include <DDSTextureLoader.h>
 
-enum class TextureStorageType
-{
-	Invalid,
-	None,
-	EmbeddedIndexCompressed,
-	EmbeddedIndexNonCompressed,
-	EmbeddedCompressed,
-	EmbeddedNonCompressed,
-	Disk
-};
-
 class Texture
 {
 public:
@@ -25,10 +14,10 @@ public:
 	Texture(ID3D11Device* device, const std::string& filePath, aiTextureType type);
 	Texture(ID3D11Device* device, const uint8_t* pData, size_t size, aiTextureType type);
 	
-	aiTextureType GetType();
+	aiTextureType GetType() const;
 	aiString GetName();
 	void SetName(const aiString& name);
-	ID3D11ShaderResourceView* GetTextureResourceView();
+	ID3D11ShaderResourceView* GetTextureResourceView() const;
 	ID3D11ShaderResourceView** GetTextureResourceViewAddress();
 
 	UINT GetWidth();
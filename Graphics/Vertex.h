@@ -1,5 +1,6 @@
 #pragma once
 #include <DirectXMath.h>
+#include <cstdint>
 
 struct Vertex
 {
@@ -12,4 +13,37 @@ struct Vertex
 	DirectX::XMFLOAT3 normal;
 	DirectX::XMFLOAT3 tangent;
 	DirectX::XMFLOAT3 biNormal;
-};
\ No newline at end of file
+};
+
+// Layout of the model vertex buffers, Vertex as it is imported or one of the packed ones
+enum class VertexFormat
+{
+	Full,
+	Packed,         // PackedVertex
+	PackedQuantized // QuantizedVertex
+};
+
+// Opt in to a packed format here, meshes are converted when they are uploaded and the shaders follow it
+constexpr VertexFormat MODEL_VERTEX_FORMAT = VertexFormat::Full;
+
+/* Vertex with the tangent frame and texture coordinate packed, 24 bytes instead of 56.
+*  The binormal is rebuilt in the vertex shader as cross(normal, tangent) * sign */
+struct PackedVertex
+{
+	DirectX::XMFLOAT3 pos;
+	uint16_t texCoord[2]; // Half floats
+	int16_t normal[2];    // Octahedral, snorm
+	uint32_t tangent;     // Octahedral in the lowest 10 + 10 bits (unorm), binormal sign in the top 2 bits
+};
+
+// PackedVertex with the position quantized to the bounds of the mesh, 20 bytes
+struct QuantizedVertex
+{
+	int16_t pos[4];       // Snorm, relative to the center of the mesh and scaled by its largest half extent. w is 1
+	uint16_t texCoord[2];
+	int16_t normal[2];
+	uint32_t tangent;
+};
+
+static_assert(sizeof(PackedVertex) == 24, "PackedVertex has to match the packed input layout");
+static_assert(sizeof(QuantizedVertex) == 20, "QuantizedVertex has to match the quantized input layout");
@@ -0,0 +1,53 @@
+#include "MemoryReport.h"
+#include <cstdio>
+
+void MemoryReport::Add(const std::string& type, size_t objectSize, size_t count, size_t ownedBytes)
+{
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].type == type)
+		{
+			entries[i].count += count;
+			entries[i].ownedBytes += ownedBytes;
+			return;
+		}
+	}
+
+	Entry entry;
+	entry.type = type;
+	entry.objectSize = objectSize;
+	entry.count = count;
+	entry.ownedBytes = ownedBytes;
+	entries.push_back(entry);
+}
+
+void MemoryReport::Clear()
+{
+	entries.clear();
+}
+
+size_t MemoryReport::GetTotalBytes() const
+{
+	size_t total = 0;
+	for (size_t i = 0; i < entries.size(); i++)
+		total += (entries[i].objectSize * entries[i].count) + entries[i].ownedBytes;
+	return total;
+}
+
+// One line per type in the order they were added, then the total
+std::string MemoryReport::ToString() const
+{
+	std::string report;
+	char line[256];
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const Entry& entry = entries[i];
+		snprintf(line, sizeof(line), "%-28s %6zu x %6zu B + %9zu B owned = %10zu B\n", entry.type.c_str(), entry.count, entry.objectSize,
+			entry.ownedBytes, (entry.objectSize * entry.count) + entry.ownedBytes);
+		report += line;
+	}
+
+	snprintf(line, sizeof(line), "%-28s %50zu B\n", "Total", GetTotalBytes());
+	report += line;
+	return report;
+}
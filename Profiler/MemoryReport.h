@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+*  Bytes used per object type, to keep an eye on memory as object counts grow.
+*
+*  Whoever owns the objects adds them with the size of one object and how many there are,
+*  plus the heap memory they own (meshes of a model, contents of a vector). Adding a type
+*  again adds to the counts already there.
+*/
+class MemoryReport
+{
+public:
+	void Add(const std::string& type, size_t objectSize, size_t count = 1, size_t ownedBytes = 0);
+	void Clear();
+
+	size_t GetTotalBytes() const;
+	std::string ToString() const;
+
+private:
+	struct Entry
+	{
+		std::string type;
+		size_t objectSize;
+		size_t count;
+		size_t ownedBytes;
+	};
+
+	std::vector<Entry> entries;
+};
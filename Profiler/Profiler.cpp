@@ -0,0 +1,204 @@
+#include "Profiler.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define PROFILER_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_TSC 1
+#endif
+
+/* Ring buffer of one thread. Only the owning thread writes, the write index is published
+*  with release so an export sees every record below it complete */
+struct ProfilerThreadBuffer
+{
+	ProfilerZoneRecord records[PROFILER_BUFFER_SIZE];
+	std::atomic<uint64_t> writeIndex{ 0 };
+	uint32_t depth = 0;
+	uint32_t threadId = 0;
+	std::string threadName;
+};
+
+static uint64_t SteadyNanoseconds()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Clock reading taken when the first zone is recorded, export measures the tick rate from it
+struct ProfilerCalibration
+{
+	ProfilerCalibration()
+	{
+		ticks = Profiler::Now();
+		nanoseconds = SteadyNanoseconds();
+	}
+
+	uint64_t ticks;
+	uint64_t nanoseconds;
+};
+
+static const ProfilerCalibration& GetCalibration()
+{
+	static ProfilerCalibration calibration;
+	return calibration;
+}
+
+std::atomic<bool> Profiler::enabled{ false };
+
+// Buffers of every thread that recorded a zone, they live until the program exits
+static std::mutex bufferMutex;
+static std::vector<std::unique_ptr<ProfilerThreadBuffer>> threadBuffers;
+
+static ProfilerThreadBuffer& GetThreadBuffer()
+{
+	thread_local ProfilerThreadBuffer* buffer = nullptr;
+	if (buffer == nullptr)
+	{
+		GetCalibration();
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		threadBuffers.push_back(std::unique_ptr<ProfilerThreadBuffer>(new ProfilerThreadBuffer));
+		buffer = threadBuffers.back().get();
+		buffer->threadId = static_cast<uint32_t>(threadBuffers.size());
+	}
+	return *buffer;
+}
+
+// Names are literals in the code, only quotes and backslashes need escaping
+static void WriteJsonString(std::ofstream& file, const char* text)
+{
+	file << '"';
+	for (const char* c = text; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			file << '\\';
+		file << *c;
+	}
+	file << '"';
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+	Profiler::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::IsEnabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+// Shown as the thread name in the trace
+void Profiler::SetThreadName(const char* name)
+{
+	ProfilerThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(bufferMutex);
+	buffer.threadName = name;
+}
+
+// Drops every recorded zone, should not be called while other threads are recording
+void Profiler::Clear()
+{
+	std::lock_guard<std::mutex> lock(bufferMutex);
+	for (size_t i = 0; i < threadBuffers.size(); i++)
+		threadBuffers[i]->writeIndex.store(0, std::memory_order_release);
+}
+
+/* Writes the zones of every thread as complete ("X") events, timestamps in microseconds.
+*  Zones still being recorded while exporting may be left out */
+bool Profiler::ExportChromeTrace(const std::string& filePath)
+{
+	std::ofstream file(filePath, std::ios::trunc);
+	if (!file)
+		return false;
+	file << std::fixed << std::setprecision(3);
+
+	// Nanoseconds per tick over the time since the first zone, long enough to be accurate
+	const ProfilerCalibration& calibration = GetCalibration();
+	uint64_t elapsedTicks = Now() - calibration.ticks;
+	uint64_t elapsedNanoseconds = SteadyNanoseconds() - calibration.nanoseconds;
+	double microsecondsPerTick = (elapsedTicks > 0) ? (elapsedNanoseconds / 1000.0) / elapsedTicks : 0.001;
+
+	std::lock_guard<std::mutex> lock(bufferMutex);
+
+	// Times are written relative to the oldest zone so they stay short
+	uint64_t origin = UINT64_MAX;
+	for (size_t i = 0; i < threadBuffers.size(); i++)
+	{
+		const ProfilerThreadBuffer& buffer = *threadBuffers[i];
+		uint64_t end = buffer.writeIndex.load(std::memory_order_acquire);
+		uint64_t begin = (end > PROFILER_BUFFER_SIZE) ? end - PROFILER_BUFFER_SIZE : 0;
+		for (uint64_t j = begin; j < end; j++)
+		{
+			uint64_t start = buffer.records[j & (PROFILER_BUFFER_SIZE - 1)].start;
+			origin = (start < origin) ? start : origin;
+		}
+	}
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	for (size_t i = 0; i < threadBuffers.size(); i++)
+	{
+		const ProfilerThreadBuffer& buffer = *threadBuffers[i];
+		if (!buffer.threadName.empty())
+		{
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.threadId << ",\"args\":{\"name\":";
+			WriteJsonString(file, buffer.threadName.c_str());
+			file << "}}";
+			first = false;
+		}
+
+		uint64_t end = buffer.writeIndex.load(std::memory_order_acquire);
+		uint64_t begin = (end > PROFILER_BUFFER_SIZE) ? end - PROFILER_BUFFER_SIZE : 0;
+		for (uint64_t j = begin; j < end; j++)
+		{
+			const ProfilerZoneRecord& record = buffer.records[j & (PROFILER_BUFFER_SIZE - 1)];
+			file << (first ? "" : ",\n") << "{\"name\":";
+			WriteJsonString(file, record.name);
+			file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.threadId
+				 << ",\"ts\":" << (record.start - origin) * microsecondsPerTick
+				 << ",\"dur\":" << (record.end - record.start) * microsecondsPerTick
+				 << ",\"args\":{\"depth\":" << record.depth << "}}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+// Time stamp counter, or steady clock nanoseconds where there is none
+uint64_t Profiler::Now()
+{
+#ifdef PROFILER_TSC
+	return __rdtsc();
+#else
+	return SteadyNanoseconds();
+#endif
+}
+
+// Returns the buffer of the calling thread, the zone hands it back to EndZone
+ProfilerThreadBuffer* Profiler::BeginZone()
+{
+	ProfilerThreadBuffer& buffer = GetThreadBuffer();
+	buffer.depth++;
+	return &buffer;
+}
+
+void Profiler::EndZone(ProfilerThreadBuffer* buffer, const char* name, uint64_t start)
+{
+	uint64_t end = Now();
+	buffer->depth--;
+
+	uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+	ProfilerZoneRecord& record = buffer->records[index & (PROFILER_BUFFER_SIZE - 1)];
+	record.name = name;
+	record.start = start;
+	record.end = end;
+	record.depth = buffer->depth;
+	buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+struct ProfilerThreadBuffer;
+
+constexpr uint32_t PROFILER_BUFFER_SIZE = 1 << 16; // Zones kept per thread, the oldest are overwritten
+
+// A finished zone, times are in ticks of the profiler clock
+struct ProfilerZoneRecord
+{
+	const char* name;
+	uint64_t start;
+	uint64_t end;
+	uint32_t depth;
+};
+
+/*
+*  Scoped CPU timing zones, exported as Chrome trace JSON (chrome://tracing or ui.perfetto.dev).
+*
+*  Every thread writes its zones into its own ring buffer, so recording takes no locks.
+*  Zones are timed with the CPU time stamp counter where there is one, and converted to
+*  time against the steady clock when exported.
+*  Zones nest by scope, the trace viewer shows them as a hierarchy per thread.
+*  When profiling is disabled a zone costs one relaxed atomic load, defining
+*  SNAKE3D_DISABLE_PROFILER removes the zones from the build altogether.
+*/
+class Profiler
+{
+public:
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+	static void SetThreadName(const char* name);
+	static void Clear();
+	static bool ExportChromeTrace(const std::string& filePath);
+
+	static uint64_t Now();
+	static ProfilerThreadBuffer* BeginZone();
+	static void EndZone(ProfilerThreadBuffer* buffer, const char* name, uint64_t start);
+
+private:
+	static std::atomic<bool> enabled;
+};
+
+// Times the enclosing scope, use through PROFILE_ZONE
+class ProfilerZone
+{
+public:
+	ProfilerZone(const char* name)
+	{
+		if (!Profiler::IsEnabled())
+			return;
+		this->name = name;
+		buffer = Profiler::BeginZone();
+		start = Profiler::Now();
+	}
+
+	~ProfilerZone()
+	{
+		if (buffer != nullptr)
+			Profiler::EndZone(buffer, name, start);
+	}
+
+	ProfilerZone(const ProfilerZone&) = delete;
+	ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+private:
+	ProfilerThreadBuffer* buffer = nullptr;
+	const char* name = nullptr;
+	uint64_t start = 0;
+};
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+// Name has to be a string literal, or live as long as the profiler
+#ifdef SNAKE3D_DISABLE_PROFILER
+#define PROFILE_ZONE(name)
+#else
+#define PROFILE_ZONE(name) ProfilerZone PROFILER_CONCAT(profilerZone, __LINE__)(name)
+#endif
@@ -0,0 +1,54 @@
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(float tickRate)
+{
+	SetTickRate(tickRate);
+}
+
+/* Adds the frame time in miliseconds and returns how many ticks should run this frame */
+int FixedTimestep::Advance(double frameTime)
+{
+	accumulator += frameTime;
+
+	int ticks = 0;
+	while (accumulator >= tickLength && ticks < MAX_SIMULATION_TICKS_PER_FRAME)
+	{
+		accumulator -= tickLength;
+		ticks++;
+	}
+
+	// Frame took longer than the tick cap, drop the time instead of catching up next frame
+	if (accumulator >= tickLength)
+		accumulator = 0.0;
+
+	return ticks;
+}
+
+void FixedTimestep::Reset()
+{
+	accumulator = 0.0;
+}
+
+void FixedTimestep::SetTickRate(float tickRate)
+{
+	if (tickRate <= 0.0f)
+		return;
+
+	this->tickRate = tickRate;
+	tickLength = 1000.0f / tickRate;
+}
+
+float FixedTimestep::GetTickRate() const
+{
+	return tickRate;
+}
+
+float FixedTimestep::GetTickLength() const
+{
+	return tickLength;
+}
+
+float FixedTimestep::GetAlpha() const
+{
+	return static_cast<float>(accumulator / tickLength);
+}
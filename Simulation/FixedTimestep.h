@@ -0,0 +1,26 @@
+#pragma once
+
+constexpr float SIMULATION_TICK_RATE = 120.0f;       // Simulation ticks per second
+constexpr int MAX_SIMULATION_TICKS_PER_FRAME = 30;   // Time beyond this is dropped after a long hitch
+
+/* Accumulates frame time and hands out a fixed number of simulation ticks.
+*  The simulation then advances the same amount no matter the display rate,
+*  the remainder is used by the renderer to interpolate between the last two ticks. */
+class FixedTimestep
+{
+public:
+	FixedTimestep(float tickRate = SIMULATION_TICK_RATE);
+
+	int Advance(double frameTime);
+	void Reset();
+
+	void SetTickRate(float tickRate);
+	float GetTickRate() const;
+	float GetTickLength() const;
+	float GetAlpha() const;
+
+private:
+	double accumulator = 0.0;
+	float tickRate = SIMULATION_TICK_RATE;
+	float tickLength = 1000.0f / SIMULATION_TICK_RATE; // Miliseconds
+};
@@ -0,0 +1,264 @@
+#include "InputLog.h"
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+constexpr uint64_t MAX_EVENT_SIZE = 10 + 4; // Longest varint, then the tick rate
+
+// Header is written field by field, little endian
+template<typename T>
+static void WriteValue(std::ofstream& file, T value)
+{
+	uint8_t bytes[sizeof(T)];
+	uint64_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(T));
+	for (size_t i = 0; i < sizeof(T); i++)
+		bytes[i] = static_cast<uint8_t>(bits >> (8 * i));
+	file.write(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+template<typename T>
+static bool ReadValue(std::ifstream& file, T& value)
+{
+	uint8_t bytes[sizeof(T)];
+	if (!file.read(reinterpret_cast<char*>(bytes), sizeof(T)))
+		return false;
+	uint64_t bits = 0;
+	for (size_t i = 0; i < sizeof(T); i++)
+		bits |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+	std::memcpy(&value, &bits, sizeof(T));
+	return true;
+}
+
+void InputLog::Begin(uint64_t seed, float tickRate)
+{
+	this->seed = seed;
+	this->tickRate = tickRate;
+	endTick = 0;
+	stateHash = 0;
+	eventCount = 0;
+	lastTick = 0;
+	stream.clear();
+}
+
+// Events have to be added in tick order
+void InputLog::Add(const InputEvent& event)
+{
+	uint64_t delta = (event.tick > lastTick) ? event.tick - lastTick : 0;
+	lastTick += delta;
+	WriteVarint((delta << 3) | static_cast<uint64_t>(event.type));
+
+	if (event.type == InputEventType::KeyPress || event.type == InputEventType::KeyRelease)
+	{
+		stream.push_back(event.key);
+	}
+	else if (event.type == InputEventType::TickRate)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &event.tickRate, sizeof(bits));
+		for (int i = 0; i < 4; i++)
+			stream.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+	}
+	eventCount++;
+}
+
+void InputLog::End(uint64_t endTick, uint64_t stateHash)
+{
+	this->endTick = endTick;
+	this->stateHash = stateHash;
+}
+
+bool InputLog::Save(const std::string& filePath) const
+{
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	WriteValue(file, INPUT_LOG_MAGIC);
+	WriteValue(file, INPUT_LOG_VERSION);
+	WriteValue(file, seed);
+	WriteValue(file, tickRate);
+	WriteValue(file, endTick);
+	WriteValue(file, stateHash);
+	WriteValue(file, eventCount);
+	WriteValue(file, static_cast<uint64_t>(stream.size()));
+	file.write(reinterpret_cast<const char*>(stream.data()), stream.size());
+	return static_cast<bool>(file);
+}
+
+// Reads into a new log and only replaces this one once the whole file was read, a rejected file changes nothing
+bool InputLog::Load(const std::string& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file)
+		return false;
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	if (!ReadValue(file, magic) || magic != INPUT_LOG_MAGIC || !ReadValue(file, version) || version != INPUT_LOG_VERSION)
+		return false;
+
+	InputLog log;
+	uint64_t byteCount = 0;
+	if (!ReadValue(file, log.seed) || !ReadValue(file, log.tickRate) || !ReadValue(file, log.endTick) || !ReadValue(file, log.stateHash) ||
+		!ReadValue(file, log.eventCount) || !ReadValue(file, byteCount))
+		return false;
+
+	// The sizes come from the file, a damaged one must not make us allocate more than it holds
+	std::streamoff start = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff end = file.tellg();
+	file.seekg(start);
+	if (start < 0 || end < start || byteCount > static_cast<uint64_t>(end - start) ||
+		log.eventCount > byteCount || byteCount > log.eventCount * MAX_EVENT_SIZE || !(log.tickRate > 0.0f))
+		return false;
+
+	log.stream.resize(static_cast<size_t>(byteCount));
+	if (!file.read(reinterpret_cast<char*>(log.stream.data()), log.stream.size()))
+		return false;
+
+	log.lastTick = log.endTick;
+	*this = std::move(log);
+	return true;
+}
+
+// Decodes the event at the cursor and moves past it, false at the end of the log or if it is cut off
+bool InputLog::Read(InputLogCursor& cursor, InputEvent& event) const
+{
+	uint64_t packed;
+	size_t offset = cursor.offset;
+	if (!ReadVarint(offset, packed))
+		return false;
+
+	event.tick = cursor.tick + (packed >> 3);
+	event.type = static_cast<InputEventType>(packed & 7);
+	event.key = 0;
+	event.tickRate = 0.0f;
+
+	if (event.type == InputEventType::KeyPress || event.type == InputEventType::KeyRelease)
+	{
+		if (offset + 1 > stream.size())
+			return false;
+		event.key = stream[offset++];
+	}
+	else if (event.type == InputEventType::TickRate)
+	{
+		if (offset + 4 > stream.size())
+			return false;
+		uint32_t bits = 0;
+		for (int i = 0; i < 4; i++)
+			bits |= static_cast<uint32_t>(stream[offset++]) << (8 * i);
+		std::memcpy(&event.tickRate, &bits, sizeof(bits));
+	}
+	else if (event.type != InputEventType::SteeringOn && event.type != InputEventType::SteeringOff)
+	{
+		return false;
+	}
+
+	cursor.offset = offset;
+	cursor.tick = event.tick;
+	return true;
+}
+
+uint64_t InputLog::GetSeed() const
+{
+	return seed;
+}
+
+float InputLog::GetTickRate() const
+{
+	return tickRate;
+}
+
+uint64_t InputLog::GetEndTick() const
+{
+	return endTick;
+}
+
+uint64_t InputLog::GetStateHash() const
+{
+	return stateHash;
+}
+
+uint32_t InputLog::GetEventCount() const
+{
+	return eventCount;
+}
+
+size_t InputLog::GetByteCount() const
+{
+	return stream.size();
+}
+
+// 7 bits per byte, high bit set on every byte but the last
+void InputLog::WriteVarint(uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		stream.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	stream.push_back(static_cast<uint8_t>(value));
+}
+
+bool InputLog::ReadVarint(size_t& offset, uint64_t& value) const
+{
+	value = 0;
+	for (int shift = 0; shift < 64 && offset < stream.size(); shift += 7)
+	{
+		uint8_t byte = stream[offset++];
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+InputKeyState::InputKeyState()
+{
+	for (int i = 0; i < 256; i++)
+		keyStates[i] = false;
+}
+
+void InputKeyState::Apply(const InputEvent& event)
+{
+	switch (event.type)
+	{
+	case InputEventType::KeyPress:
+		keyStates[event.key] = true;
+		break;
+	case InputEventType::KeyRelease:
+		keyStates[event.key] = false;
+		break;
+	case InputEventType::SteeringOn:
+		relativeSteering = true;
+		break;
+	case InputEventType::SteeringOff:
+		relativeSteering = false;
+		break;
+	default:
+		break;
+	}
+}
+
+bool InputKeyState::IsPressed(unsigned char key) const
+{
+	return keyStates[key];
+}
+
+bool InputKeyState::IsRelativeSteering() const
+{
+	return relativeSteering;
+}
+
+SimulationInput InputKeyState::ToSimulationInput() const
+{
+	SimulationInput input;
+	input.start = keyStates[INPUT_KEY_START];
+	input.up = keyStates[INPUT_KEY_UP];
+	input.down = keyStates[INPUT_KEY_DOWN];
+	input.left = keyStates[INPUT_KEY_LEFT];
+	input.right = keyStates[INPUT_KEY_RIGHT];
+	input.relativeSteering = relativeSteering;
+	return input;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SnakeSimulation.h"
+
+// Keys the simulation reads, same values as the Windows virtual key codes
+constexpr unsigned char INPUT_KEY_START = 0x0D; // VK_RETURN
+constexpr unsigned char INPUT_KEY_UP = 'W';
+constexpr unsigned char INPUT_KEY_DOWN = 'S';
+constexpr unsigned char INPUT_KEY_LEFT = 'A';
+constexpr unsigned char INPUT_KEY_RIGHT = 'D';
+
+constexpr uint32_t INPUT_LOG_MAGIC = 0x49443353; // "S3DI"
+constexpr uint32_t INPUT_LOG_VERSION = 1;
+
+enum class InputEventType : uint8_t
+{
+	KeyPress,
+	KeyRelease,
+	SteeringOn,  // Third person camera, left/right turn relative to the heading
+	SteeringOff,
+	TickRate
+};
+
+struct InputEvent
+{
+	uint64_t tick = 0;  // Simulation tick the event happened after, it applies from the next one
+	InputEventType type = InputEventType::KeyPress;
+	unsigned char key = 0;
+	float tickRate = 0.0f;
+};
+
+// Position of the next event when reading a log
+struct InputLogCursor
+{
+	size_t offset = 0;
+	uint64_t tick = 0;
+};
+
+/*
+*  Every keyboard event of a session with the simulation tick it happened on.
+*
+*  Events are encoded as they are added: the ticks since the previous event and the type
+*  packed into a variable length integer, then the key. Most events take two or three bytes,
+*  so a whole session can be kept in memory and written out at the end.
+*
+*  Together with the seed this is everything the simulation depends on, replaying the
+*  log gives the same game tick for tick.
+*/
+class InputLog
+{
+public:
+	void Begin(uint64_t seed, float tickRate);
+	void Add(const InputEvent& event);
+	void End(uint64_t endTick, uint64_t stateHash);
+
+	bool Save(const std::string& filePath) const;
+	bool Load(const std::string& filePath);
+	bool Read(InputLogCursor& cursor, InputEvent& event) const;
+
+	uint64_t GetSeed() const;
+	float GetTickRate() const;
+	uint64_t GetEndTick() const;
+	uint64_t GetStateHash() const;
+	uint32_t GetEventCount() const;
+	size_t GetByteCount() const;
+
+private:
+	void WriteVarint(uint64_t value);
+	bool ReadVarint(size_t& offset, uint64_t& value) const;
+
+	uint64_t seed = 0;
+	float tickRate = 0.0f;
+	uint64_t endTick = 0;
+	uint64_t stateHash = 0;  // Of the simulation at the end tick, a replay should end with the same
+	uint32_t eventCount = 0;
+	uint64_t lastTick = 0;
+	std::vector<uint8_t> stream;
+};
+
+// Key and steering state rebuilt from events, gives the simulation input for a tick
+class InputKeyState
+{
+public:
+	InputKeyState();
+
+	void Apply(const InputEvent& event);
+	bool IsPressed(unsigned char key) const;
+	bool IsRelativeSteering() const;
+	SimulationInput ToSimulationInput() const;
+
+private:
+	bool keyStates[256];
+	bool relativeSteering = false;
+};
@@ -0,0 +1,96 @@
+#include "InputReplay.h"
+
+static void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+}
+
+InputReplay::InputReplay(const InputLog& log) : log(log), simulation(log.GetSeed())
+{
+	tickLength = 1000.0f / log.GetTickRate();
+	hasPendingEvent = log.Read(cursor, pendingEvent);
+}
+
+// Steps one tick, false once the end of the recording is reached
+bool InputReplay::Step()
+{
+	if (IsFinished())
+		return false;
+
+	uint64_t tick = simulation.GetTick();
+	while (hasPendingEvent && pendingEvent.tick <= tick)
+	{
+		if (pendingEvent.type == InputEventType::TickRate)
+			tickLength = 1000.0f / pendingEvent.tickRate;
+		else
+			keyState.Apply(pendingEvent);
+		hasPendingEvent = log.Read(cursor, pendingEvent);
+	}
+
+	bool wasGameOver = simulation.IsGameOver();
+	simulation.Step(keyState.ToSimulationInput(), tickLength);
+	if (!wasGameOver && simulation.IsGameOver())
+		gameOverTick = simulation.GetTick();
+	return true;
+}
+
+void InputReplay::Run()
+{
+	while (Step())
+		;
+}
+
+bool InputReplay::IsFinished() const
+{
+	return simulation.GetTick() >= log.GetEndTick();
+}
+
+bool InputReplay::MatchesRecording() const
+{
+	return IsFinished() && HashState(simulation) == log.GetStateHash();
+}
+
+// Tick the game ended on, 0 if it has not
+uint64_t InputReplay::GetGameOverTick() const
+{
+	return gameOverTick;
+}
+
+const SnakeSimulation& InputReplay::GetSimulation() const
+{
+	return simulation;
+}
+
+/* FNV-1a over everything that makes up the game state, the bits of every float are hashed
+*  so any difference between the recording and the replay changes it */
+uint64_t InputReplay::HashState(const SnakeSimulation& simulation)
+{
+	uint64_t hash = 14695981039346656037ull;
+	uint64_t tick = simulation.GetTick();
+	int score = simulation.GetScore();
+	float speed = simulation.GetSpeed();
+	uint8_t flags = static_cast<uint8_t>((simulation.IsGameStarted() ? 1 : 0) | (simulation.IsGameOver() ? 2 : 0));
+	HashBytes(hash, &tick, sizeof(tick));
+	HashBytes(hash, &score, sizeof(score));
+	HashBytes(hash, &speed, sizeof(speed));
+	HashBytes(hash, &flags, sizeof(flags));
+
+	const SnakeSegment& head = simulation.GetHead();
+	HashBytes(hash, &head.position, sizeof(head.position));
+	HashBytes(hash, &head.yaw, sizeof(head.yaw));
+
+	const SnakeBody& body = simulation.GetBody();
+	HashBytes(hash, body.GetPositionX(), body.Size() * sizeof(float));
+	HashBytes(hash, body.GetPositionZ(), body.Size() * sizeof(float));
+	HashBytes(hash, body.GetYaw(), body.Size() * sizeof(float));
+
+	// Active list order depends on the order of spawns and pickups, so it is hashed as is
+	const std::vector<uint32_t>& activePickups = simulation.GetActivePickups();
+	HashBytes(hash, activePickups.data(), activePickups.size() * sizeof(uint32_t));
+	return hash;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "InputLog.h"
+#include "SnakeSimulation.h"
+
+/*
+*  Plays an InputLog back through a simulation without a window or a clock.
+*
+*  Events recorded after tick N are applied before tick N + 1 is stepped, the same as the
+*  engine applies the keys read during a frame to every tick it runs that frame. So the
+*  replay reaches the same state as the recorded session, and runs as fast as the
+*  simulation can step.
+*/
+class InputReplay
+{
+public:
+	InputReplay(const InputLog& log);
+
+	bool Step();
+	void Run();
+
+	bool IsFinished() const;
+	bool MatchesRecording() const;
+	uint64_t GetGameOverTick() const;
+	const SnakeSimulation& GetSimulation() const;
+
+	static uint64_t HashState(const SnakeSimulation& simulation);
+
+private:
+	const InputLog& log;
+	SnakeSimulation simulation;
+	InputKeyState keyState;
+	InputLogCursor cursor;
+	InputEvent pendingEvent;
+	bool hasPendingEvent = false;
+	float tickLength = 0.0f;
+	uint64_t gameOverTick = 0;
+};
@@ -0,0 +1,244 @@
+#include "PickupField.h"
+#include <algorithm>
+#include <utility>
+
+PickupField::PickupField(int rows, int columns, const SimFloat3& origin, float columnSpacing, float rowSpacing, float occupantRadius)
+{
+	this->rows = rows;
+	this->columns = columns;
+	this->origin = origin;
+	this->columnSpacing = columnSpacing;
+	this->rowSpacing = rowSpacing;
+	this->occupantRadius = occupantRadius;
+
+	for (int i = 0; i < rows; i++)
+	{
+		for (int j = 0; j < columns; j++)
+		{
+			Pickup pickup;
+			pickup.position = SimFloat3(origin.x + (columnSpacing * j), origin.y, origin.z + (rowSpacing * i));
+			pickups.push_back(pickup);
+		}
+	}
+
+	active.reserve(pickups.size());
+	freeCells.reserve(pickups.size());
+	Reset();
+}
+
+// Hides every pickup and removes every occupant
+void PickupField::Reset()
+{
+	for (size_t i = 0; i < pickups.size(); i++)
+		pickups[i].isVisible = false;
+	active.clear();
+	activeSlot.assign(pickups.size(), PICKUP_NONE);
+
+	freeCells.clear();
+	freeSlot.assign(pickups.size(), PICKUP_NONE);
+	occupantCount.assign(pickups.size(), 0);
+	occupied.assign((pickups.size() + 63) / 64, 0);
+	occupantCells.clear();
+
+	for (uint32_t i = 0; i < pickups.size(); i++)
+		AddFree(i);
+}
+
+bool PickupField::Activate(uint32_t index)
+{
+	if (index >= pickups.size() || activeSlot[index] != PICKUP_NONE)
+		return false;
+
+	pickups[index].isVisible = true;
+	activeSlot[index] = static_cast<uint32_t>(active.size());
+	active.push_back(index);
+	RemoveFree(index);
+	return true;
+}
+
+// Swaps the last active pickup into the removed slot, the order of the active list is not kept
+bool PickupField::Deactivate(uint32_t index)
+{
+	if (index >= pickups.size() || activeSlot[index] == PICKUP_NONE)
+		return false;
+
+	uint32_t slot = activeSlot[index];
+	uint32_t last = active.back();
+	active[slot] = last;
+	activeSlot[last] = slot;
+	active.pop_back();
+
+	pickups[index].isVisible = false;
+	activeSlot[index] = PICKUP_NONE;
+	if (!IsOccupied(index))
+		AddFree(index);
+	return true;
+}
+
+bool PickupField::IsActive(uint32_t index) const
+{
+	return index < pickups.size() && activeSlot[index] != PICKUP_NONE;
+}
+
+// Activates a random free pickup and returns its index, -1 if every cell is active or occupied
+int PickupField::SpawnRandom(SimRandom& random)
+{
+	if (freeCells.empty())
+		return -1;
+
+	uint32_t index = freeCells[random.NextBelow(static_cast<uint32_t>(freeCells.size()))];
+	Activate(index);
+	return static_cast<int>(index);
+}
+
+void PickupField::ClearOccupants()
+{
+	for (size_t i = 0; i < occupantCells.size(); i++)
+		AddOccupancy(occupantCells[i], -1);
+	occupantCells.clear();
+}
+
+/* Moves an occupant, new ids are added as they are first moved.
+*  Only an occupant that crossed into other cells touches the counts, so moving the whole
+*  snake every tick mostly costs the cell calculation */
+void PickupField::MoveOccupant(uint32_t occupant, float x, float z)
+{
+	if (occupant >= occupantCells.size())
+		occupantCells.resize(occupant + 1);
+
+	CellRange range = CellsInBox(x - occupantRadius, z - occupantRadius, x + occupantRadius, z + occupantRadius);
+	CellRange& previous = occupantCells[occupant];
+	if (range.minRow == previous.minRow && range.maxRow == previous.maxRow &&
+		range.minColumn == previous.minColumn && range.maxColumn == previous.maxColumn)
+		return;
+
+	// Add before removing so cells covered by both ranges never become free in between
+	AddOccupancy(range, 1);
+	AddOccupancy(previous, -1);
+	previous = range;
+}
+
+bool PickupField::IsOccupied(uint32_t index) const
+{
+	return (occupied[index >> 6] >> (index & 63)) & 1;
+}
+
+/* Index of the active pickup first within radius on both axes of a point moving from -> to, -1 if there is none.
+*  Time is from 0 to 1 along the movement, pickups hit after maxTime are ignored */
+int PickupField::FindCollision(const SimFloat3& from, const SimFloat3& to, float radius, float maxTime, float& time) const
+{
+	CellRange range = CellsInBox(fminf(from.x, to.x) - radius, fminf(from.z, to.z) - radius,
+	                             fmaxf(from.x, to.x) + radius, fmaxf(from.z, to.z) + radius);
+	int hit = -1;
+	for (int i = range.minRow; i <= range.maxRow; i++)
+	{
+		for (int j = range.minColumn; j <= range.maxColumn; j++)
+		{
+			uint32_t index = static_cast<uint32_t>((i * columns) + j);
+			if (activeSlot[index] == PICKUP_NONE)
+				continue;
+
+			const SimFloat3& position = pickups[index].position;
+			float pickupTime;
+			if (SimSweepSquare(from, to, position.x, position.z, radius, pickupTime) && pickupTime <= maxTime)
+			{
+				hit = static_cast<int>(index);
+				maxTime = pickupTime;
+			}
+		}
+	}
+
+	if (hit >= 0)
+		time = maxTime;
+	return hit;
+}
+
+const std::vector<Pickup>& PickupField::GetPickups() const
+{
+	return pickups;
+}
+
+const std::vector<uint32_t>& PickupField::GetActive() const
+{
+	return active;
+}
+
+size_t PickupField::GetFreeCount() const
+{
+	return freeCells.size();
+}
+
+size_t PickupField::Size() const
+{
+	return pickups.size();
+}
+
+// Rows and columns with their pickup inside the box, clamped to the lattice
+PickupField::CellRange PickupField::CellsInBox(float minX, float minZ, float maxX, float maxZ) const
+{
+	float firstColumn = (minX - origin.x) / columnSpacing;
+	float lastColumn = (maxX - origin.x) / columnSpacing;
+	float firstRow = (minZ - origin.z) / rowSpacing;
+	float lastRow = (maxZ - origin.z) / rowSpacing;
+	if (firstColumn > lastColumn)
+		std::swap(firstColumn, lastColumn);
+	if (firstRow > lastRow)
+		std::swap(firstRow, lastRow);
+
+	CellRange range;
+	// Pickups on the edge of the box are included so rounding in the tests never misses a cell.
+	// Clamped on both sides so positions far outside the lattice give an empty range
+	float columnLimit = static_cast<float>(columns);
+	float rowLimit = static_cast<float>(rows);
+	range.minColumn = static_cast<int16_t>(std::min(std::max(ceilf(firstColumn), 0.0f), columnLimit));
+	range.maxColumn = static_cast<int16_t>(std::min(std::max(floorf(lastColumn), -1.0f), columnLimit - 1.0f));
+	range.minRow = static_cast<int16_t>(std::min(std::max(ceilf(firstRow), 0.0f), rowLimit));
+	range.maxRow = static_cast<int16_t>(std::min(std::max(floorf(lastRow), -1.0f), rowLimit - 1.0f));
+	return range;
+}
+
+void PickupField::AddOccupancy(const CellRange& range, int delta)
+{
+	for (int i = range.minRow; i <= range.maxRow; i++)
+	{
+		for (int j = range.minColumn; j <= range.maxColumn; j++)
+		{
+			uint32_t index = static_cast<uint32_t>((i * columns) + j);
+			occupantCount[index] = static_cast<uint16_t>(occupantCount[index] + delta);
+
+			uint64_t bit = 1ull << (index & 63);
+			if (occupantCount[index] == 0)
+			{   // Last occupant left the cell
+				occupied[index >> 6] &= ~bit;
+				if (activeSlot[index] == PICKUP_NONE)
+					AddFree(index);
+			}
+			else if (delta > 0 && occupantCount[index] == 1)
+			{   // First occupant entered the cell
+				occupied[index >> 6] |= bit;
+				RemoveFree(index);
+			}
+		}
+	}
+}
+
+void PickupField::AddFree(uint32_t index)
+{
+	if (freeSlot[index] != PICKUP_NONE)
+		return;
+	freeSlot[index] = static_cast<uint32_t>(freeCells.size());
+	freeCells.push_back(index);
+}
+
+void PickupField::RemoveFree(uint32_t index)
+{
+	if (freeSlot[index] == PICKUP_NONE)
+		return;
+
+	uint32_t slot = freeSlot[index];
+	uint32_t last = freeCells.back();
+	freeCells[slot] = last;
+	freeSlot[last] = slot;
+	freeCells.pop_back();
+	freeSlot[index] = PICKUP_NONE;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "SimMath.h"
+#include "SimRandom.h"
+
+constexpr uint32_t PICKUP_NONE = 0xFFFFFFFF; // Slot of a pickup that is not in a list
+
+struct Pickup
+{
+	SimFloat3 position;
+	bool isVisible = false;
+};
+
+/* Pickups laid out on a regular lattice, indexed by their cell.
+*
+*  Finding the pickup the head runs into is a lookup of the cells covered by its movement
+*  for the tick, which is one or two cells at normal speed. Visible pickups are also kept in a compact list so the game loop and the renderer
+*  only go over the ones that are active.
+*
+*  Occupants (the snake) mark the cells they cover in a bitmap, and the cells that are
+*  neither active nor occupied are kept in a free set, so a spawn is one random pick from
+*  that set and never lands under the snake. */
+class PickupField
+{
+public:
+	PickupField(int rows, int columns, const SimFloat3& origin, float columnSpacing, float rowSpacing, float occupantRadius);
+
+	void Reset();
+	bool Activate(uint32_t index);
+	bool Deactivate(uint32_t index);
+	bool IsActive(uint32_t index) const;
+	int SpawnRandom(SimRandom& random);
+
+	void ClearOccupants();
+	void MoveOccupant(uint32_t occupant, float x, float z);
+	bool IsOccupied(uint32_t index) const;
+
+	int FindCollision(const SimFloat3& from, const SimFloat3& to, float radius, float maxTime, float& time) const;
+
+	const std::vector<Pickup>& GetPickups() const;
+	const std::vector<uint32_t>& GetActive() const;
+	size_t GetFreeCount() const;
+	size_t Size() const;
+
+private:
+	// Cells an occupant covers, empty when the maximum is below the minimum
+	struct CellRange
+	{
+		int16_t minRow = 0;
+		int16_t maxRow = -1;
+		int16_t minColumn = 0;
+		int16_t maxColumn = -1;
+	};
+
+	CellRange CellsInBox(float minX, float minZ, float maxX, float maxZ) const;
+	void AddOccupancy(const CellRange& range, int delta);
+	void AddFree(uint32_t index);
+	void RemoveFree(uint32_t index);
+
+	int rows;
+	int columns;
+	SimFloat3 origin;     // Position of the pickup in row 0, column 0
+	float columnSpacing;  // Along x
+	float rowSpacing;     // Along z
+	float occupantRadius; // Cells with their pickup within this of an occupant on both axes are covered
+
+	std::vector<Pickup> pickups;      // Row by row, index is row * columns + column
+	std::vector<uint32_t> active;     // Indices of the visible pickups
+	std::vector<uint32_t> activeSlot; // Where every pickup is in active, PICKUP_NONE if it isn't
+	std::vector<uint32_t> freeCells;  // Indices of the pickups that can be spawned
+	std::vector<uint32_t> freeSlot;   // Where every pickup is in freeCells, PICKUP_NONE if it isn't
+
+	std::vector<uint16_t> occupantCount; // Occupants covering every cell
+	std::vector<uint64_t> occupied;      // One bit per cell, set while its occupant count is above zero
+	std::vector<CellRange> occupantCells; // Cells every occupant covered when it was last moved
+};
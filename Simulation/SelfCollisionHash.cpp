@@ -0,0 +1,160 @@
+#include "SelfCollisionHash.h"
+#include <cmath>
+
+SelfCollisionHash::SelfCollisionHash(float segmentSpacing) : hash(segmentSpacing)
+{
+	this->segmentSpacing = segmentSpacing;
+}
+
+void SelfCollisionHash::Reset()
+{
+	// Forces a rebuild on the next update
+	capacity = 0;
+	oldestInserted = 0;
+	nextInserted = 0;
+	seenSamples = 0;
+	trackedSegments = 0;
+}
+
+/* Call after the body has been placed on the trail.
+*  Inserts the samples written since the last update and removes the ones behind the tail */
+void SelfCollisionHash::Update(const SnakeTrail& trail, size_t segmentCount)
+{
+	trackedSegments = segmentCount;
+
+	// Ids depend on the trail capacity, and a reset trail starts counting from the start again
+	uint64_t sampleCount = trail.GetSampleCount();
+	if (trail.GetCapacity() != capacity || sampleCount < seenSamples)
+	{
+		Rebuild(trail);
+		return;
+	}
+	seenSamples = sampleCount;
+
+	uint64_t firstStored = sampleCount - trail.GetStoredCount();
+	float tailDistance = segmentSpacing * static_cast<float>(segmentCount + 1);
+	while (oldestInserted < nextInserted && (oldestInserted < firstStored || trail.GetDistanceOf(oldestInserted) > tailDistance))
+	{
+		hash.Remove(IdOf(oldestInserted));
+		oldestInserted += SELF_COLLISION_SAMPLE_STRIDE;
+	}
+
+	for (; nextInserted < sampleCount; nextInserted += SELF_COLLISION_SAMPLE_STRIDE)
+	{
+		const TrailSample& sample = trail.GetSample(nextInserted);
+		hash.Insert(IdOf(nextInserted), sample.position.x, sample.position.z);
+	}
+}
+
+// Lowest index of a segment within radius of the position on both axes, -1 if there is none
+int SelfCollisionHash::Query(const SimFloat3& position, float radius, const SnakeTrail& trail, const SnakeBody& body) const
+{
+	float time;
+	return Query(position, position, radius, trail, body, time);
+}
+
+/*
+*  Segment the head first hits moving in a straight line from -> to during the last tick, -1 if there is none.
+*  Time is from 0 to 1 along the movement, ties go to the lowest index. Same result as testing every segment.
+*
+*  Hashed samples are (stride * sample spacing) apart along the trail, so every segment on the hashed
+*  part has one within half of that. The radius plus that distance is less than the cell size, so
+*  the sample is in the cells around the movement and its distance along the trail rounds to the segment.
+*/
+int SelfCollisionHash::Query(const SimFloat3& from, const SimFloat3& to, float radius, const SnakeTrail& trail, const SnakeBody& body, float& time) const
+{
+	size_t segmentCount = body.Size();
+	size_t hit = segmentCount;
+	float hitTime = 2.0f;
+	float step = SimLength(to - from);
+
+	uint64_t ringMask = capacity - 1;
+	hash.QueryBox(fminf(from.x, to.x), fminf(from.z, to.z), fmaxf(from.x, to.x), fmaxf(from.z, to.z), candidates);
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		// Ids wrap with the trail ring buffer, the inserted range is never longer than it
+		uint64_t sampleIndex = oldestInserted + (((candidates[i] * SELF_COLLISION_SAMPLE_STRIDE) - oldestInserted) & ringMask);
+		float segment = (trail.GetDistanceOf(sampleIndex) / segmentSpacing) - 1.0f;
+		int64_t nearest = static_cast<int64_t>(floorf(segment + 0.5f));
+
+		for (int64_t j = nearest - 1; j <= nearest + 1; j++)
+		{
+			if (j < 0 || static_cast<size_t>(j) >= segmentCount)
+				continue;
+
+			float segmentTime;
+			if (TestSegment(static_cast<size_t>(j), from, to, radius, step, body, segmentTime) &&
+				(segmentTime < hitTime || (segmentTime == hitTime && static_cast<size_t>(j) < hit)))
+			{
+				hit = static_cast<size_t>(j);
+				hitTime = segmentTime;
+			}
+		}
+	}
+
+	// Segments past the oldest hashed sample or added after the last update
+	size_t untracked = trackedSegments;
+	if (oldestInserted < nextInserted)
+	{
+		float hashedLength = trail.GetDistanceOf(oldestInserted);
+		size_t hashedSegments = static_cast<size_t>(hashedLength / segmentSpacing);
+		untracked = (hashedSegments < untracked) ? hashedSegments : untracked;
+	}
+	else
+	{
+		untracked = 0;
+	}
+	for (size_t j = (untracked > 0) ? untracked - 1 : 0; j < segmentCount; j++)
+	{
+		float segmentTime;
+		if (TestSegment(j, from, to, radius, step, body, segmentTime) && (segmentTime < hitTime || (segmentTime == hitTime && j < hit)))
+		{
+			hit = j;
+			hitTime = segmentTime;
+		}
+	}
+
+	if (hit == segmentCount)
+		return -1;
+	time = hitTime;
+	return static_cast<int>(hit);
+}
+
+uint32_t SelfCollisionHash::IdOf(uint64_t sampleIndex) const
+{
+	return static_cast<uint32_t>((sampleIndex / SELF_COLLISION_SAMPLE_STRIDE) & ((capacity / SELF_COLLISION_SAMPLE_STRIDE) - 1));
+}
+
+void SelfCollisionHash::Rebuild(const SnakeTrail& trail)
+{
+	capacity = trail.GetCapacity();
+	seenSamples = trail.GetSampleCount();
+	hash.Clear(capacity / SELF_COLLISION_SAMPLE_STRIDE);
+
+	// First stored sample rounded up to the stride
+	uint64_t firstStored = trail.GetSampleCount() - trail.GetStoredCount();
+	oldestInserted = ((firstStored + SELF_COLLISION_SAMPLE_STRIDE - 1) / SELF_COLLISION_SAMPLE_STRIDE) * SELF_COLLISION_SAMPLE_STRIDE;
+	nextInserted = oldestInserted;
+	for (; nextInserted < trail.GetSampleCount(); nextInserted += SELF_COLLISION_SAMPLE_STRIDE)
+	{
+		const TrailSample& sample = trail.GetSample(nextInserted);
+		hash.Insert(IdOf(nextInserted), sample.position.x, sample.position.z);
+	}
+}
+
+/* Segments that were within the distance moved this tick of the head are the body the head just laid
+*  down, the sweep would always pass over them. They are only tested where the head ended up, like before */
+bool SelfCollisionHash::TestSegment(size_t segment, const SimFloat3& from, const SimFloat3& to, float radius, float step,
+	                                const SnakeBody& body, float& time) const
+{
+	float x = body.GetPositionX()[segment];
+	float z = body.GetPositionZ()[segment];
+	if (segmentSpacing * static_cast<float>(segment) < step)
+	{
+		if (fabsf(to.x - x) >= radius || fabsf(to.z - z) >= radius)
+			return false;
+		time = 1.0f;
+		return true;
+	}
+	return SimSweepSquare(from, to, x, z, radius, time);
+}
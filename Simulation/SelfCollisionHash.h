@@ -0,0 +1,49 @@
+#pragma once
+#include "SnakeBody.h"
+#include "SnakeTrail.h"
+#include "SpatialHash.h"
+
+constexpr uint64_t SELF_COLLISION_SAMPLE_STRIDE = 4; // Every 4th trail sample is put in the hash
+
+/*
+*  Broadphase for the head hitting its own body.
+*
+*  The body always lies on the trail of the head, so instead of rehashing every segment
+*  every tick the trail is hashed as it is written: new trail samples are inserted and
+*  samples that fall behind the tail are removed, which is a handful of points per tick
+*  however long the snake is. Cell size is the segment spacing.
+*
+*  A sample found near the head gives its distance along the trail, and from that the
+*  index of the segment next to it, so the head is only tested against a few segments.
+*  Segments that are not on the hashed part of the trail yet are tested directly.
+*
+*  The head can also be swept along its movement for the tick, so it can not pass through
+*  the body between two ticks however fast it goes.
+*/
+class SelfCollisionHash
+{
+public:
+	SelfCollisionHash(float segmentSpacing);
+
+	void Reset();
+	void Update(const SnakeTrail& trail, size_t segmentCount);
+	int Query(const SimFloat3& position, float radius, const SnakeTrail& trail, const SnakeBody& body) const;
+	int Query(const SimFloat3& from, const SimFloat3& to, float radius, const SnakeTrail& trail, const SnakeBody& body, float& time) const;
+
+private:
+	uint32_t IdOf(uint64_t sampleIndex) const;
+	void Rebuild(const SnakeTrail& trail);
+	bool TestSegment(size_t segment, const SimFloat3& from, const SimFloat3& to, float radius, float step,
+	                 const SnakeBody& body, float& time) const;
+
+	SpatialHash hash;
+	float segmentSpacing;
+
+	size_t capacity = 0;          // Trail capacity the ids are laid out for
+	uint64_t oldestInserted = 0;  // Sample indices in the hash, both multiples of the stride
+	uint64_t nextInserted = 0;
+	uint64_t seenSamples = 0;     // Trail sample count at the last update
+	size_t trackedSegments = 0;   // Segments that were placed on the trail when Update was called
+
+	mutable std::vector<uint32_t> candidates;
+};
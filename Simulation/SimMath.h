@@ -0,0 +1,103 @@
+#pragma once
+#include <cmath>
+
+// SSE is used for the bulk loops when the target has it, otherwise they fall back to scalar code
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define SIM_SSE 1
+#include <emmintrin.h>
+#endif
+
+/* Minimal vector math used by the simulation.
+*  The simulation must build without DirectXMath so it can run headless on any platform,
+*  SimFloat3 has the same layout as DirectX::XMFLOAT3 so the renderer can copy it straight over. */
+
+constexpr float SIM_PI = 3.141592654f;
+constexpr float SIM_PIDIV2 = 1.570796327f;
+
+struct SimFloat3
+{
+	SimFloat3() : x(0.0f), y(0.0f), z(0.0f) {}
+	SimFloat3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+	float x;
+	float y;
+	float z;
+};
+
+// Row major 4x4 matrix, same layout as DirectX::XMFLOAT4X4
+struct SimMatrix
+{
+	float m[4][4];
+};
+
+inline SimFloat3 operator+(const SimFloat3& a, const SimFloat3& b) { return SimFloat3(a.x + b.x, a.y + b.y, a.z + b.z); }
+inline SimFloat3 operator-(const SimFloat3& a, const SimFloat3& b) { return SimFloat3(a.x - b.x, a.y - b.y, a.z - b.z); }
+inline SimFloat3 operator*(const SimFloat3& a, float s) { return SimFloat3(a.x * s, a.y * s, a.z * s); }
+
+inline float SimDot(const SimFloat3& a, const SimFloat3& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline float SimLength(const SimFloat3& a)
+{
+	return sqrtf(SimDot(a, a));
+}
+
+// Forward vector for a rotation around Y, matches GameObject3D::GetForwardVector with no pitch
+inline SimFloat3 SimForwardFromYaw(float yaw)
+{
+	return SimFloat3(sinf(yaw), 0.0f, cosf(yaw));
+}
+
+inline SimFloat3 SimLerp(const SimFloat3& a, const SimFloat3& b, float t)
+{
+	return a + ((b - a) * t);
+}
+
+// Interpolates between two angles the short way around
+inline float SimLerpAngle(float a, float b, float t)
+{
+	float difference = fmodf(b - a, 2.0f * SIM_PI);
+	if (difference > SIM_PI)
+		difference -= 2.0f * SIM_PI;
+	else if (difference < -SIM_PI)
+		difference += 2.0f * SIM_PI;
+	return a + (difference * t);
+}
+
+/* Time from 0 to 1 at which a point moving from -> to on the ground plane is first strictly
+*  inside the square of halfExtent around (centerX, centerZ). False if it never is.
+*  A point that starts inside hits at time 0, with from == to this is the plain overlap test */
+inline bool SimSweepSquare(const SimFloat3& from, const SimFloat3& to, float centerX, float centerZ, float halfExtent, float& time)
+{
+	const float start[2] = { from.x - centerX, from.z - centerZ };
+	const float delta[2] = { to.x - from.x, to.z - from.z };
+	float enter = 0.0f;
+	float exit = 1.0f;
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (delta[axis] == 0.0f)
+		{   // Not moving on this axis, has to be inside the whole time
+			if (fabsf(start[axis]) >= halfExtent)
+				return false;
+			continue;
+		}
+
+		float inverse = 1.0f / delta[axis];
+		float first = (-halfExtent - start[axis]) * inverse;
+		float last = (halfExtent - start[axis]) * inverse;
+		if (first > last)
+		{
+			float swap = first;
+			first = last;
+			last = swap;
+		}
+		enter = (first > enter) ? first : enter;
+		exit = (last < exit) ? last : exit;
+		if (enter >= exit)
+			return false;
+	}
+	time = enter;
+	return true;
+}
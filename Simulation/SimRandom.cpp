@@ -0,0 +1,45 @@
+#include "SimRandom.h"
+
+SimRandom::SimRandom(uint64_t seed)
+{
+	Seed(seed);
+}
+
+void SimRandom::Seed(uint64_t seed)
+{
+	state = 0;
+	Next();
+	state += seed;
+	Next();
+}
+
+uint32_t SimRandom::Next()
+{
+	uint64_t oldState = state;
+	state = (oldState * 6364136223846793005ull) + 1442695040888963407ull;
+	uint32_t shifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+	uint32_t rotation = static_cast<uint32_t>(oldState >> 59u);
+	return (shifted >> rotation) | (shifted << ((32u - rotation) & 31u));
+}
+
+/* Uniform number from 0 up to but not including bound.
+*  Values that would make the low numbers more likely than the rest (like rand() % bound does) are thrown away */
+uint32_t SimRandom::NextBelow(uint32_t bound)
+{
+	if (bound == 0)
+		return 0;
+
+	uint32_t threshold = (0u - bound) % bound;
+	for (;;)
+	{
+		uint32_t value = Next();
+		if (value >= threshold)
+			return value % bound;
+	}
+}
+
+// Uniform number from minimum up to but not including maximum
+uint32_t SimRandom::NextInRange(uint32_t minimum, uint32_t maximum)
+{
+	return minimum + NextBelow(maximum - minimum);
+}
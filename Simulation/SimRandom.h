@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+constexpr uint64_t SIM_DEFAULT_SEED = 0x853C49E6748FEA9Bull;
+
+/* Small seedable random generator (PCG32) owned by each simulation.
+*  Unlike rand() it has no global state, so two simulations seeded the same way
+*  make the same choices on any platform and compiler. */
+class SimRandom
+{
+public:
+	SimRandom(uint64_t seed = SIM_DEFAULT_SEED);
+
+	void Seed(uint64_t seed);
+	uint32_t Next();
+	uint32_t NextBelow(uint32_t bound);
+	uint32_t NextInRange(uint32_t minimum, uint32_t maximum);
+
+private:
+	uint64_t state = 0;
+};
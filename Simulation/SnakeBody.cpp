@@ -0,0 +1,276 @@
+#include "SnakeBody.h"
+
+// Lerped forward vectors are normalized the same way with and without SSE, so both give the same matrices
+constexpr float SMALLEST_LENGTH_SQUARED = 1e-12f;
+
+// Same matrix as XMMatrixRotationY(yaw) * XMMatrixTranslation(x, y, z), built from the forward vector
+static inline void WriteWorldMatrix(SimMatrix& matrix, float x, float y, float z, float forwardX, float forwardZ)
+{
+	matrix.m[0][0] = forwardZ; matrix.m[0][1] = 0.0f; matrix.m[0][2] = -forwardX; matrix.m[0][3] = 0.0f;
+	matrix.m[1][0] = 0.0f;     matrix.m[1][1] = 1.0f; matrix.m[1][2] = 0.0f;      matrix.m[1][3] = 0.0f;
+	matrix.m[2][0] = forwardX; matrix.m[2][1] = 0.0f; matrix.m[2][2] = forwardZ;  matrix.m[2][3] = 0.0f;
+	matrix.m[3][0] = x;        matrix.m[3][1] = y;    matrix.m[3][2] = z;         matrix.m[3][3] = 1.0f;
+}
+
+void SnakeBody::Clear()
+{
+	positionX.clear();
+	positionY.clear();
+	positionZ.clear();
+	yaw.clear();
+	forwardX.clear();
+	forwardZ.clear();
+}
+
+void SnakeBody::Reserve(size_t count)
+{
+	positionX.reserve(count);
+	positionY.reserve(count);
+	positionZ.reserve(count);
+	yaw.reserve(count);
+	forwardX.reserve(count);
+	forwardZ.reserve(count);
+}
+
+void SnakeBody::Resize(size_t count)
+{
+	positionX.resize(count);
+	positionY.resize(count);
+	positionZ.resize(count);
+	yaw.resize(count);
+	forwardX.resize(count);
+	forwardZ.resize(count);
+}
+
+void SnakeBody::Add(const SimFloat3& position, float yaw)
+{
+	SimFloat3 forward = SimForwardFromYaw(yaw);
+	positionX.push_back(position.x);
+	positionY.push_back(position.y);
+	positionZ.push_back(position.z);
+	this->yaw.push_back(yaw);
+	forwardX.push_back(forward.x);
+	forwardZ.push_back(forward.z);
+}
+
+/*
+*  Places segment i spacing * (i + 1) units behind the head along the trail.
+*
+*  Segments between two recorded samples are placed four at a time: the distances, sample
+*  indices and lerp factors are computed in one go, the samples are gathered from the ring
+*  buffer and lerped together. The results are the same as SnakeTrail::Sample, which places
+*  the few segments in front of the newest sample and the ones past the recorded trail.
+*/
+void SnakeBody::Follow(const SnakeTrail& trail, float spacing)
+{
+	size_t count = Size();
+	float headOffset = trail.GetHeadOffset();
+	float sampleSpacing = trail.GetSampleSpacing();
+	uint64_t stored = trail.GetStoredCount();
+
+	size_t i = 0;
+	for (; i < count && spacing * (i + 1) <= headOffset; i++)
+		SetFromSample(i, trail.Sample(spacing * (i + 1)));
+
+	// Distances grow with the index, so the segments past the recorded trail are all at the end
+	size_t recorded = count;
+	while (recorded > i && static_cast<uint64_t>((spacing * recorded - headOffset) / sampleSpacing) + 1 >= stored)
+		recorded--;
+
+	float* x = positionX.data();
+	float* y = positionY.data();
+	float* z = positionZ.data();
+	float* segmentYaw = yaw.data();
+	float* fx = forwardX.data();
+	float* fz = forwardZ.data();
+
+#ifdef SIM_SSE
+	const __m128 laneOffsets = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+	const __m128 spacings = _mm_set1_ps(spacing);
+	const __m128 offsets = _mm_set1_ps(headOffset);
+	const __m128 sampleSpacings = _mm_set1_ps(sampleSpacing);
+	for (; i + 4 <= recorded; i += 4)
+	{
+		__m128 distance = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(i)), laneOffsets), spacings);
+		__m128 back = _mm_div_ps(_mm_sub_ps(distance, offsets), sampleSpacings);
+		__m128i steps = _mm_cvttps_epi32(back);
+		__m128 t = _mm_sub_ps(back, _mm_cvtepi32_ps(steps));
+
+		int32_t step[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(step), steps);
+		const TrailSample* newer[4];
+		const TrailSample* older[4];
+		for (int j = 0; j < 4; j++)
+		{
+			newer[j] = &trail.GetSampleBack(static_cast<uint64_t>(step[j]));
+			older[j] = &trail.GetSampleBack(static_cast<uint64_t>(step[j]) + 1);
+		}
+
+		__m128 nx = _mm_setr_ps(newer[0]->position.x, newer[1]->position.x, newer[2]->position.x, newer[3]->position.x);
+		__m128 ny = _mm_setr_ps(newer[0]->position.y, newer[1]->position.y, newer[2]->position.y, newer[3]->position.y);
+		__m128 nz = _mm_setr_ps(newer[0]->position.z, newer[1]->position.z, newer[2]->position.z, newer[3]->position.z);
+		__m128 ox = _mm_setr_ps(older[0]->position.x, older[1]->position.x, older[2]->position.x, older[3]->position.x);
+		__m128 oy = _mm_setr_ps(older[0]->position.y, older[1]->position.y, older[2]->position.y, older[3]->position.y);
+		__m128 oz = _mm_setr_ps(older[0]->position.z, older[1]->position.z, older[2]->position.z, older[3]->position.z);
+		_mm_storeu_ps(&x[i], _mm_add_ps(nx, _mm_mul_ps(_mm_sub_ps(ox, nx), t)));
+		_mm_storeu_ps(&y[i], _mm_add_ps(ny, _mm_mul_ps(_mm_sub_ps(oy, ny), t)));
+		_mm_storeu_ps(&z[i], _mm_add_ps(nz, _mm_mul_ps(_mm_sub_ps(oz, nz), t)));
+		_mm_storeu_ps(&segmentYaw[i], _mm_setr_ps(newer[0]->yaw, newer[1]->yaw, newer[2]->yaw, newer[3]->yaw));
+		_mm_storeu_ps(&fx[i], _mm_setr_ps(newer[0]->forwardX, newer[1]->forwardX, newer[2]->forwardX, newer[3]->forwardX));
+		_mm_storeu_ps(&fz[i], _mm_setr_ps(newer[0]->forwardZ, newer[1]->forwardZ, newer[2]->forwardZ, newer[3]->forwardZ));
+	}
+#endif
+
+	for (; i < recorded; i++)
+	{
+		float back = (spacing * (i + 1) - headOffset) / sampleSpacing;
+		uint64_t steps = static_cast<uint64_t>(back);
+		float t = back - static_cast<float>(steps);
+		const TrailSample& newer = trail.GetSampleBack(steps);
+		const TrailSample& older = trail.GetSampleBack(steps + 1);
+		x[i] = newer.position.x + ((older.position.x - newer.position.x) * t);
+		y[i] = newer.position.y + ((older.position.y - newer.position.y) * t);
+		z[i] = newer.position.z + ((older.position.z - newer.position.z) * t);
+		segmentYaw[i] = newer.yaw;
+		fx[i] = newer.forwardX;
+		fz[i] = newer.forwardZ;
+	}
+
+	for (; i < count; i++)
+		SetFromSample(i, trail.Sample(spacing * (i + 1)));
+}
+
+void SnakeBody::BuildWorldMatrices(SimMatrix* matrices) const
+{
+	BuildWorldMatrices(*this, 1.0f, matrices);
+}
+
+/* Writes one world matrix per segment, interpolated alpha of the way from previous to this body.
+*  Segments that don't exist in previous are written as they are now. */
+void SnakeBody::BuildWorldMatrices(const SnakeBody& previous, float alpha, SimMatrix* matrices) const
+{
+	size_t count = Size();
+	size_t interpolated = (previous.Size() < count) ? previous.Size() : count;
+	size_t i = 0;
+
+#ifdef SIM_SSE
+	// Four segments at a time, the component arrays are transposed into matrix rows
+	const __m128 a = _mm_set1_ps(alpha);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 negativeZero = _mm_set1_ps(-0.0f); // Flips the sign like the scalar -forwardX, 0 becomes -0
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 smallest = _mm_set1_ps(SMALLEST_LENGTH_SQUARED);
+	const __m128 up = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+	for (; i + 4 <= interpolated; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(&previous.positionX[i]);
+		__m128 py = _mm_loadu_ps(&previous.positionY[i]);
+		__m128 pz = _mm_loadu_ps(&previous.positionZ[i]);
+		__m128 pfx = _mm_loadu_ps(&previous.forwardX[i]);
+		__m128 pfz = _mm_loadu_ps(&previous.forwardZ[i]);
+
+		__m128 x = _mm_add_ps(px, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&positionX[i]), px), a));
+		__m128 y = _mm_add_ps(py, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&positionY[i]), py), a));
+		__m128 z = _mm_add_ps(pz, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&positionZ[i]), pz), a));
+		__m128 fx = _mm_add_ps(pfx, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&forwardX[i]), pfx), a));
+		__m128 fz = _mm_add_ps(pfz, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&forwardZ[i]), pfz), a));
+
+		// Lerped forward vectors are shorter than 1 while turning
+		__m128 lengthSquared = _mm_max_ps(_mm_add_ps(_mm_mul_ps(fx, fx), _mm_mul_ps(fz, fz)), smallest);
+		__m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+		fx = _mm_mul_ps(fx, inverseLength);
+		fz = _mm_mul_ps(fz, inverseLength);
+
+		__m128 right0 = fz, right1 = zero, right2 = _mm_xor_ps(fx, negativeZero), right3 = zero;
+		__m128 forward0 = fx, forward1 = zero, forward2 = fz, forward3 = zero;
+		__m128 position0 = x, position1 = y, position2 = z, position3 = one;
+		_MM_TRANSPOSE4_PS(right0, right1, right2, right3);
+		_MM_TRANSPOSE4_PS(forward0, forward1, forward2, forward3);
+		_MM_TRANSPOSE4_PS(position0, position1, position2, position3);
+
+		const __m128 rights[4] = { right0, right1, right2, right3 };
+		const __m128 forwards[4] = { forward0, forward1, forward2, forward3 };
+		const __m128 positions[4] = { position0, position1, position2, position3 };
+		for (int j = 0; j < 4; j++)
+		{
+			SimMatrix& matrix = matrices[i + j];
+			_mm_storeu_ps(matrix.m[0], rights[j]);
+			_mm_storeu_ps(matrix.m[1], up);
+			_mm_storeu_ps(matrix.m[2], forwards[j]);
+			_mm_storeu_ps(matrix.m[3], positions[j]);
+		}
+	}
+#endif
+
+	for (; i < interpolated; i++)
+	{
+		float fx = previous.forwardX[i] + ((forwardX[i] - previous.forwardX[i]) * alpha);
+		float fz = previous.forwardZ[i] + ((forwardZ[i] - previous.forwardZ[i]) * alpha);
+		float lengthSquared = (fx * fx) + (fz * fz);
+		float inverseLength = 1.0f / sqrtf((lengthSquared > SMALLEST_LENGTH_SQUARED) ? lengthSquared : SMALLEST_LENGTH_SQUARED);
+		fx *= inverseLength;
+		fz *= inverseLength;
+
+		WriteWorldMatrix(matrices[i],
+			previous.positionX[i] + ((positionX[i] - previous.positionX[i]) * alpha),
+			previous.positionY[i] + ((positionY[i] - previous.positionY[i]) * alpha),
+			previous.positionZ[i] + ((positionZ[i] - previous.positionZ[i]) * alpha),
+			fx, fz);
+	}
+
+	for (; i < count; i++)
+		WriteWorldMatrix(matrices[i], positionX[i], positionY[i], positionZ[i], forwardX[i], forwardZ[i]);
+}
+
+size_t SnakeBody::Size() const
+{
+	return positionX.size();
+}
+
+bool SnakeBody::Empty() const
+{
+	return positionX.empty();
+}
+
+SnakeSegment SnakeBody::GetSegment(size_t index) const
+{
+	SnakeSegment segment;
+	segment.position = SimFloat3(positionX[index], positionY[index], positionZ[index]);
+	segment.yaw = yaw[index];
+	return segment;
+}
+
+SnakeSegment SnakeBody::Back() const
+{
+	return GetSegment(Size() - 1);
+}
+
+const float* SnakeBody::GetPositionX() const
+{
+	return positionX.data();
+}
+
+const float* SnakeBody::GetPositionY() const
+{
+	return positionY.data();
+}
+
+const float* SnakeBody::GetPositionZ() const
+{
+	return positionZ.data();
+}
+
+const float* SnakeBody::GetYaw() const
+{
+	return yaw.data();
+}
+
+void SnakeBody::SetFromSample(size_t index, const TrailSample& sample)
+{
+	positionX[index] = sample.position.x;
+	positionY[index] = sample.position.y;
+	positionZ[index] = sample.position.z;
+	yaw[index] = sample.yaw;
+	forwardX[index] = sample.forwardX;
+	forwardZ[index] = sample.forwardZ;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+
+#include "SimMath.h"
+#include "SnakeTrail.h"
+
+struct SnakeSegment
+{
+	SimFloat3 position;
+	float yaw = 0.0f;
+};
+
+/* Body segments of a snake stored as one array per component (structure of arrays).
+*
+*  The whole body is placed along the trail in one pass and the renderer gets all world
+*  matrices from one call, so no per segment objects, virtual calls or trigonometry are
+*  needed however long the snake gets. Every segment moves at the speed of the head,
+*  so speed is not stored per segment. */
+class SnakeBody
+{
+public:
+	void Clear();
+	void Reserve(size_t count);
+	void Resize(size_t count);
+	void Add(const SimFloat3& position, float yaw);
+
+	void Follow(const SnakeTrail& trail, float spacing);
+	void BuildWorldMatrices(SimMatrix* matrices) const;
+	void BuildWorldMatrices(const SnakeBody& previous, float alpha, SimMatrix* matrices) const;
+
+	size_t Size() const;
+	bool Empty() const;
+	SnakeSegment GetSegment(size_t index) const;
+	SnakeSegment Back() const;
+
+	const float* GetPositionX() const;
+	const float* GetPositionY() const;
+	const float* GetPositionZ() const;
+	const float* GetYaw() const;
+
+private:
+	void SetFromSample(size_t index, const TrailSample& sample);
+
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> positionZ;
+	std::vector<float> yaw;
+	std::vector<float> forwardX; // sin(yaw)
+	std::vector<float> forwardZ; // cos(yaw)
+};
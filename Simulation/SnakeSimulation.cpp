@@ -0,0 +1,326 @@
+#include "SnakeSimulation.h"
+#include <utility>
+
+SnakeSimulation::SnakeSimulation(uint64_t seed)
+{
+	Reset(seed);
+}
+
+// Starts a new game with the same seed as the last one
+void SnakeSimulation::Reset()
+{
+	Reset(seed);
+}
+
+void SnakeSimulation::Reset(uint64_t seed)
+{
+	this->seed = seed;
+	random.Seed(seed);
+
+	head.position = SimFloat3(0.0f, 36.0f, 0.0f);
+	head.yaw = 0.0f;
+
+	// The snake starts with a tail right behind the head
+	body.Clear();
+	body.Add(SimFloat3(0.0f, 36.0f, -SNAKE_SEGMENT_SPACING), 0.0f);
+
+	previousHead = head;
+	previousBody = body;
+
+	trail.Reset(head.position, head.yaw);
+	trail.Reserve(SNAKE_SEGMENT_SPACING * (body.Size() + 1));
+	bodyHash.Reset();
+
+	pickups.Reset();
+	UpdatePickupOccupancy();
+
+	heading = Heading::Up;
+	targetYaw = 0.0f;
+	isTurning = false;
+	distanceSinceTurn = SNAKE_SEGMENT_SPACING;
+
+	speed = SNAKE_START_SPEED;
+	spawnTimer = 0.0f;
+	nextSpawnTime = NextSpawnTime();
+	score = 0;
+	tick = 0;
+	collisionTime = 1.0f;
+
+	gameStarted = false;
+	gameOver = false;
+}
+
+void SnakeSimulation::Step(const SimulationInput& input, float dt)
+{
+	tick++;
+
+	if (input.start)
+		gameStarted = true;
+
+	previousHead = head;
+	if (!gameStarted || gameOver)
+	{
+		previousBody = body;
+		return;
+	}
+
+	// MoveBody rewrites every segment, so the buffers are swapped instead of copied
+	std::swap(previousBody, body);
+	body.Resize(previousBody.Size());
+
+	HandleTurning(input, dt);
+	MoveHead(dt);
+	MoveBody();
+	// Collisions first, pickups the head reaches after hitting something are not collected
+	HandleCollisions();
+	HandlePickups(dt);
+}
+
+bool SnakeSimulation::AddBodySegment()
+{
+	// New tail spawns behind the current tail facing the same way
+	SnakeSegment tail = body.Back();
+	body.Add(tail.position - (SimForwardFromYaw(tail.yaw) * SNAKE_SEGMENT_SPACING), tail.yaw);
+
+	// Trail keeps one segment of history past the tail so the next segment has a path to follow
+	trail.Reserve(SNAKE_SEGMENT_SPACING * (body.Size() + 1));
+	return true;
+}
+
+bool SnakeSimulation::SpawnPickup()
+{
+	// Picks from the cells that are neither visible nor under the snake, fails if there are none
+	return pickups.SpawnRandom(random) >= 0;
+}
+
+const SnakeSegment& SnakeSimulation::GetHead() const
+{
+	return head;
+}
+
+const SnakeBody& SnakeSimulation::GetBody() const
+{
+	return body;
+}
+
+const SnakeSegment& SnakeSimulation::GetPreviousHead() const
+{
+	return previousHead;
+}
+
+const SnakeBody& SnakeSimulation::GetPreviousBody() const
+{
+	return previousBody;
+}
+
+const std::vector<Pickup>& SnakeSimulation::GetPickups() const
+{
+	return pickups.GetPickups();
+}
+
+const std::vector<uint32_t>& SnakeSimulation::GetActivePickups() const
+{
+	return pickups.GetActive();
+}
+
+int SnakeSimulation::GetScore() const
+{
+	return score;
+}
+
+float SnakeSimulation::GetSpeed() const
+{
+	return speed;
+}
+
+uint64_t SnakeSimulation::GetTick() const
+{
+	return tick;
+}
+
+uint64_t SnakeSimulation::GetSeed() const
+{
+	return seed;
+}
+
+bool SnakeSimulation::IsGameStarted() const
+{
+	return gameStarted;
+}
+
+bool SnakeSimulation::IsGameOver() const
+{
+	return gameOver;
+}
+
+bool SnakeSimulation::IsTurnPending() const
+{
+	return isTurning || distanceSinceTurn < SNAKE_SEGMENT_SPACING;
+}
+
+bool SnakeSimulation::CompareFloat(const SimFloat3& current, const SimFloat3& previous, float epsilon)
+{
+	// Only compares the ground plane, height is ignored
+	return (fabsf(current.x - previous.x) < epsilon) && (fabsf(current.z - previous.z) < epsilon);
+}
+
+SnakeSegment SnakeSimulation::Interpolate(const SnakeSegment& previous, const SnakeSegment& current, float alpha)
+{
+	SnakeSegment segment;
+	segment.position = SimLerp(previous.position, current.position, alpha);
+	segment.yaw = SimLerpAngle(previous.yaw, current.yaw, alpha);
+	return segment;
+}
+
+void SnakeSimulation::HandleTurning(const SimulationInput& input, float dt)
+{
+	// Relative turns rotate over time, no new turn is accepted until it is done
+	if (isTurning)
+	{
+		float step = SNAKE_TURN_RATE * dt;
+		float remaining = targetYaw - head.yaw;
+		if (fabsf(remaining) <= step)
+		{
+			head.yaw = targetYaw;
+			isTurning = false;
+		}
+		else
+		{
+			head.yaw += (remaining > 0.0f) ? step : -step;
+		}
+		return;
+	}
+
+	// Body has to reach the previous turn before the head can turn again
+	if (distanceSinceTurn < SNAKE_SEGMENT_SPACING)
+		return;
+
+	if (input.relativeSteering)
+	{
+		int current = static_cast<int>(heading);
+		if (input.right)
+			StartTurn(static_cast<Heading>((current + 1) % 4), head.yaw + SIM_PIDIV2, true);
+		else if (input.left)
+			StartTurn(static_cast<Heading>((current + 3) % 4), head.yaw - SIM_PIDIV2, true);
+		return;
+	}
+
+	// Absolute steering, the snake can only turn onto the other axis
+	bool isHorizontal = (heading == Heading::Left || heading == Heading::Right);
+	if (input.right && !isHorizontal)
+		StartTurn(Heading::Right, SIM_PIDIV2, false);
+	else if (input.left && !isHorizontal)
+		StartTurn(Heading::Left, -SIM_PIDIV2, false);
+	else if (input.up && isHorizontal)
+		StartTurn(Heading::Up, 0.0f, false);
+	else if (input.down && isHorizontal)
+		StartTurn(Heading::Down, SIM_PI, false);
+}
+
+void SnakeSimulation::MoveHead(float dt)
+{
+	// Speed is in units per 100 miliseconds
+	float distance = (speed / 100.0f) * dt;
+	head.position = head.position + (SimForwardFromYaw(head.yaw) * distance);
+	distanceSinceTurn += distance;
+	trail.Advance(head.position, head.yaw);
+}
+
+void SnakeSimulation::MoveBody()
+{
+	body.Follow(trail, SNAKE_SEGMENT_SPACING);
+	bodyHash.Update(trail, body.Size());
+	UpdatePickupOccupancy();
+}
+
+// Head and every body segment mark the pickup cells they cover so nothing spawns under them
+void SnakeSimulation::UpdatePickupOccupancy()
+{
+	pickups.MoveOccupant(0, head.position.x, head.position.z);
+
+	const float* positionX = body.GetPositionX();
+	const float* positionZ = body.GetPositionZ();
+	for (size_t i = 0; i < body.Size(); i++)
+		pickups.MoveOccupant(static_cast<uint32_t>(i + 1), positionX[i], positionZ[i]);
+}
+
+void SnakeSimulation::HandlePickups(float dt)
+{
+	// Handle pickup spawns
+	spawnTimer += dt;
+	if (spawnTimer > nextSpawnTime)
+	{
+		SpawnPickup();
+		spawnTimer = 0.0f;
+		nextSpawnTime = NextSpawnTime();
+	}
+
+	/* Handle pickup collisions along the whole movement of the head this tick, so pickups
+	   are not skipped at high speed. Only the lattice cells under the movement are tested */
+	int index;
+	float time;
+	while ((index = pickups.FindCollision(previousHead.position, head.position, PICKUP_RADIUS, collisionTime, time)) >= 0)
+	{   // Pickup was collected
+		pickups.Deactivate(static_cast<uint32_t>(index));
+		score++;
+		AddBodySegment();
+		speed += SNAKE_PICKUP_SPEED_BONUS;
+	}
+}
+
+/* Tests the movement of the head this tick, not only where it ended up, so it can not
+*  pass through the body or a corner of the play area at any speed */
+void SnakeSimulation::HandleCollisions()
+{
+	collisionTime = 1.0f;
+
+	// Head outside of the play area
+	float exitTime = ArenaExitTime(previousHead.position, head.position);
+	if (exitTime <= 1.0f)
+	{
+		gameOver = true;
+		collisionTime = exitTime;
+	}
+
+	// Head hitting its own body
+	float hitTime;
+	if (bodyHash.Query(previousHead.position, head.position, SELF_COLLISION_RADIUS, trail, body, hitTime) >= 0)
+	{
+		gameOver = true;
+		collisionTime = fminf(collisionTime, hitTime);
+	}
+}
+
+// Time from 0 to 1 along the movement at which the head leaves the play area, above 1 if it stays inside
+float SnakeSimulation::ArenaExitTime(const SimFloat3& from, const SimFloat3& to) const
+{
+	float exitTime = 2.0f;
+	const float start[2] = { from.x, from.z };
+	const float end[2] = { to.x, to.z };
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (fabsf(end[axis]) <= PLAY_AREA_HALF_EXTENT)
+			continue;
+		if (fabsf(start[axis]) > PLAY_AREA_HALF_EXTENT)
+			return 0.0f;
+
+		float wall = (end[axis] > 0.0f) ? PLAY_AREA_HALF_EXTENT : -PLAY_AREA_HALF_EXTENT;
+		exitTime = fminf(exitTime, (wall - start[axis]) / (end[axis] - start[axis]));
+	}
+	return exitTime;
+}
+
+void SnakeSimulation::StartTurn(Heading heading, float yaw, bool animated)
+{
+	this->heading = heading;
+	targetYaw = yaw;
+	isTurning = animated;
+	if (!animated)
+		head.yaw = yaw;
+	distanceSinceTurn = 0.0f;
+}
+
+float SnakeSimulation::NextSpawnTime()
+{
+	return static_cast<float>(random.NextInRange(4500, 10500));
+}
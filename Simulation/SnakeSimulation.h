@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "SimMath.h"
+#include "PickupField.h"
+#include "SelfCollisionHash.h"
+#include "SimRandom.h"
+#include "SnakeBody.h"
+#include "SnakeTrail.h"
+
+/* Game rules of Snake3D without any window, device or model dependencies.
+*  The engine feeds it input every tick and the renderer reads the resulting state back. */
+
+constexpr float SNAKE_SEGMENT_SPACING = 73.0f;       // Distance between the head and every body segment
+constexpr float SNAKE_START_SPEED = 20.0f;           // Matches the old characterSpeedModifier
+constexpr float SNAKE_PICKUP_SPEED_BONUS = 0.2f;     // Speed added for every pickup
+constexpr float SNAKE_TURN_RATE = 0.012f;            // Radians per milisecond for relative turns
+constexpr float PLAY_AREA_HALF_EXTENT = 980.0f;      // Head outside of this is game over
+constexpr float PICKUP_RADIUS = 40.0f;
+constexpr float SELF_COLLISION_RADIUS = 36.0f;       // 73 / 2
+constexpr int PICKUP_ROWS = 23;
+constexpr int PICKUP_COLUMNS = 24;
+
+struct SimulationInput
+{
+	bool start = false;
+	bool up = false;
+	bool down = false;
+	bool left = false;
+	bool right = false;
+	bool relativeSteering = false; // Left/right turns relative to the heading (third person camera)
+};
+
+class SnakeSimulation
+{
+public:
+	SnakeSimulation(uint64_t seed = SIM_DEFAULT_SEED);
+
+	void Reset();
+	void Reset(uint64_t seed);
+	void Step(const SimulationInput& input, float dt);
+
+	bool AddBodySegment();
+	bool SpawnPickup();
+
+	const SnakeSegment& GetHead() const;
+	const SnakeBody& GetBody() const;
+	const SnakeSegment& GetPreviousHead() const;
+	const SnakeBody& GetPreviousBody() const;
+	const std::vector<Pickup>& GetPickups() const;
+	const std::vector<uint32_t>& GetActivePickups() const;
+	int GetScore() const;
+	float GetSpeed() const;
+	uint64_t GetTick() const;
+	uint64_t GetSeed() const;
+	bool IsGameStarted() const;
+	bool IsGameOver() const;
+	bool IsTurnPending() const;
+
+	static bool CompareFloat(const SimFloat3& current, const SimFloat3& previous, float epsilon = 1.0f);
+	static SnakeSegment Interpolate(const SnakeSegment& previous, const SnakeSegment& current, float alpha);
+
+private:
+	enum class Heading {
+		Up,
+		Right,
+		Down,
+		Left
+	};
+
+	void HandleTurning(const SimulationInput& input, float dt);
+	void MoveHead(float dt);
+	void MoveBody();
+	void UpdatePickupOccupancy();
+	void HandlePickups(float dt);
+	void HandleCollisions();
+	float ArenaExitTime(const SimFloat3& from, const SimFloat3& to) const;
+	void StartTurn(Heading heading, float yaw, bool animated);
+	float NextSpawnTime();
+
+	SnakeSegment head;
+	SnakeBody body;
+	// Fixed lattice of pickups, made active when spawned
+	PickupField pickups = PickupField(PICKUP_ROWS, PICKUP_COLUMNS, SimFloat3(-930.0f, 5.0f, 930.0f), 80.0f, -85.0f,
+	                                  PICKUP_RADIUS + SELF_COLLISION_RADIUS);
+
+	// State before the last tick, used by the renderer to interpolate
+	SnakeSegment previousHead;
+	SnakeBody previousBody;
+
+	// Path of the head, the body is placed along it
+	SnakeTrail trail = SnakeTrail(SNAKE_SEGMENT_SPACING / 8.0f);
+	// Trail by grid cell, so the head only tests the segments around it
+	SelfCollisionHash bodyHash = SelfCollisionHash(SNAKE_SEGMENT_SPACING);
+
+	Heading heading = Heading::Up;
+	float targetYaw = 0.0f;
+	bool isTurning = false;
+	float distanceSinceTurn = SNAKE_SEGMENT_SPACING;
+
+	float speed = SNAKE_START_SPEED;
+	float spawnTimer = 0.0f;
+	float nextSpawnTime = 0.0f;
+	int score = 0;
+	uint64_t tick = 0;
+	float collisionTime = 1.0f; // How far along the last tick's movement the head hit something, 1 if it didn't
+
+	// Every random choice comes from here so a seed always plays out the same game
+	SimRandom random;
+	uint64_t seed = SIM_DEFAULT_SEED;
+
+	bool gameStarted = false;
+	bool gameOver = false;
+};
@@ -0,0 +1,158 @@
+#include "SnakeTrail.h"
+
+SnakeTrail::SnakeTrail(float sampleSpacing)
+{
+	this->sampleSpacing = sampleSpacing;
+	samples.resize(64);
+	mask = samples.size() - 1;
+}
+
+void SnakeTrail::Reset(const SimFloat3& headPosition, float headYaw)
+{
+	head = MakeSample(headPosition, headYaw);
+
+	// Trail starts with a single sample under the head
+	samples[0] = head;
+	sampleCount = 1;
+	headOffset = 0.0f;
+}
+
+/* Makes sure the buffer can hold the trail for the given length behind the head */
+void SnakeTrail::Reserve(float length)
+{
+	size_t required = static_cast<size_t>(length / sampleSpacing) + 2;
+	if (required <= samples.size())
+		return;
+
+	size_t capacity = samples.size();
+	while (capacity < required)
+		capacity *= 2;
+
+	// Copy the stored samples over in order so their indices stay the same
+	std::vector<TrailSample> resized(capacity);
+	uint64_t newMask = capacity - 1;
+	uint64_t stored = (sampleCount < samples.size()) ? sampleCount : samples.size();
+	for (uint64_t i = sampleCount - stored; i < sampleCount; i++)
+		resized[i & newMask] = samples[i & mask];
+
+	samples.swap(resized);
+	mask = newMask;
+}
+
+/* Moves the head in a straight line to its new position, writing a sample
+*  every time the trail gets sampleSpacing longer */
+void SnakeTrail::Advance(const SimFloat3& headPosition, float headYaw)
+{
+	SimFloat3 movement = headPosition - head.position;
+	float length = SimLength(movement);
+
+	head = MakeSample(headPosition, headYaw);
+	headOffset += length;
+
+	while (headOffset >= sampleSpacing)
+	{
+		headOffset -= sampleSpacing;
+
+		TrailSample sample = head;
+		sample.position = headPosition - (movement * (headOffset / length));
+		samples[sampleCount & mask] = sample;
+		sampleCount++;
+	}
+}
+
+/* Returns the point on the trail the given distance behind the head */
+TrailSample SnakeTrail::Sample(float distance) const
+{
+	const TrailSample& newest = At(sampleCount - 1);
+
+	// Between the newest sample and the head
+	if (distance <= headOffset)
+	{
+		TrailSample sample = head;
+		float t = (headOffset > 0.0f) ? (distance / headOffset) : 0.0f;
+		sample.position = SimLerp(head.position, newest.position, t);
+		return sample;
+	}
+
+	float back = (distance - headOffset) / sampleSpacing;
+	uint64_t steps = static_cast<uint64_t>(back);
+	float t = back - static_cast<float>(steps);
+
+	// Further back than the trail has been recorded, continue straight behind the oldest sample
+	uint64_t stored = GetStoredCount();
+	if (steps + 1 >= stored)
+	{
+		const TrailSample& oldest = At(sampleCount - stored);
+		float remaining = distance - headOffset - (sampleSpacing * (stored - 1));
+		TrailSample sample = oldest;
+		sample.position = oldest.position - (SimFloat3(oldest.forwardX, 0.0f, oldest.forwardZ) * remaining);
+		return sample;
+	}
+
+	const TrailSample& newer = At(sampleCount - 1 - steps);
+	const TrailSample& older = At(sampleCount - 2 - steps);
+	TrailSample sample = newer;
+	sample.position = SimLerp(newer.position, older.position, t);
+	return sample;
+}
+
+/* Sample stepsBack steps behind the newest one, 0 is the newest.
+*  Only samples within GetStoredCount are valid */
+const TrailSample& SnakeTrail::GetSampleBack(uint64_t stepsBack) const
+{
+	return At(sampleCount - 1 - stepsBack);
+}
+
+/* Sample by the number of samples written before it since the last reset.
+*  Only the last GetStoredCount samples are valid */
+const TrailSample& SnakeTrail::GetSample(uint64_t sampleIndex) const
+{
+	return At(sampleIndex);
+}
+
+// Distance along the trail from the head back to the sample
+float SnakeTrail::GetDistanceOf(uint64_t sampleIndex) const
+{
+	return headOffset + (sampleSpacing * static_cast<float>(sampleCount - 1 - sampleIndex));
+}
+
+float SnakeTrail::GetSampleSpacing() const
+{
+	return sampleSpacing;
+}
+
+float SnakeTrail::GetHeadOffset() const
+{
+	return headOffset;
+}
+
+uint64_t SnakeTrail::GetStoredCount() const
+{
+	return (sampleCount < samples.size()) ? sampleCount : samples.size();
+}
+
+uint64_t SnakeTrail::GetSampleCount() const
+{
+	return sampleCount;
+}
+
+size_t SnakeTrail::GetCapacity() const
+{
+	return samples.size();
+}
+
+const TrailSample& SnakeTrail::At(uint64_t sampleIndex) const
+{
+	return samples[sampleIndex & mask];
+}
+
+TrailSample SnakeTrail::MakeSample(const SimFloat3& position, float yaw)
+{
+	SimFloat3 forward = SimForwardFromYaw(yaw);
+	TrailSample sample;
+	sample.position = position;
+	sample.yaw = yaw;
+	sample.forwardX = forward.x;
+	sample.forwardZ = forward.z;
+	return sample;
+}
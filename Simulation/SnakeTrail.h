@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "SimMath.h"
+
+struct TrailSample
+{
+	SimFloat3 position;
+	float yaw = 0.0f;
+	float forwardX = 0.0f; // sin(yaw), stored so followers never need trigonometry
+	float forwardZ = 1.0f; // cos(yaw)
+};
+
+/* Path the head of a snake has travelled, used to place the body segments behind it.
+*
+*  The path is resampled at a fixed arc length spacing into a ring buffer, so the point
+*  any distance behind the head is found with one index calculation and one lerp.
+*  Capacity only grows when the snake gets longer than what the buffer covers. */
+class SnakeTrail
+{
+public:
+	SnakeTrail(float sampleSpacing = 9.125f);
+
+	void Reset(const SimFloat3& headPosition, float headYaw);
+	void Reserve(float length);
+	void Advance(const SimFloat3& headPosition, float headYaw);
+
+	TrailSample Sample(float distance) const;
+	const TrailSample& GetSampleBack(uint64_t stepsBack) const;
+	const TrailSample& GetSample(uint64_t sampleIndex) const;
+	float GetDistanceOf(uint64_t sampleIndex) const;
+
+	float GetSampleSpacing() const;
+	float GetHeadOffset() const;
+	uint64_t GetStoredCount() const;
+	uint64_t GetSampleCount() const;
+	size_t GetCapacity() const;
+
+private:
+	const TrailSample& At(uint64_t sampleIndex) const;
+	static TrailSample MakeSample(const SimFloat3& position, float yaw);
+
+	std::vector<TrailSample> samples; // Ring buffer, size is a power of two
+	uint64_t mask = 0;
+	uint64_t sampleCount = 0;         // Samples written since the last reset
+
+	float sampleSpacing;
+	float headOffset = 0.0f;          // Distance from the newest sample to the head
+	TrailSample head;
+};
@@ -0,0 +1,161 @@
+#include "SpatialHash.h"
+#include <algorithm>
+
+SpatialHash::SpatialHash(float cellSize)
+{
+	this->cellSize = cellSize;
+	inverseCellSize = 1.0f / cellSize;
+	Clear(0);
+}
+
+/* Removes every point and makes room for idCount ids.
+*  Bucket count is a power of two of at least one bucket per id so the lists stay short */
+void SpatialHash::Clear(size_t idCount)
+{
+	size_t bucketCount = 64;
+	while (bucketCount < idCount)
+		bucketCount *= 2;
+	buckets.assign(bucketCount, SPATIAL_HASH_NONE);
+	bucketMask = static_cast<uint32_t>(bucketCount - 1);
+
+	idBucket.assign(idCount, SPATIAL_HASH_NONE);
+	next.assign(idCount, SPATIAL_HASH_NONE);
+	previous.assign(idCount, SPATIAL_HASH_NONE);
+}
+
+void SpatialHash::Insert(uint32_t id, float x, float z)
+{
+	uint32_t bucket = BucketOf(x, z);
+	idBucket[id] = bucket;
+	previous[id] = SPATIAL_HASH_NONE;
+	next[id] = buckets[bucket];
+	if (buckets[bucket] != SPATIAL_HASH_NONE)
+		previous[buckets[bucket]] = id;
+	buckets[bucket] = id;
+}
+
+void SpatialHash::Remove(uint32_t id)
+{
+	if (idBucket[id] == SPATIAL_HASH_NONE)
+		return;
+
+	if (previous[id] != SPATIAL_HASH_NONE)
+		next[previous[id]] = next[id];
+	else
+		buckets[idBucket[id]] = next[id];
+
+	if (next[id] != SPATIAL_HASH_NONE)
+		previous[next[id]] = previous[id];
+
+	idBucket[id] = SPATIAL_HASH_NONE;
+}
+
+// Only relinks the point if it moved into another bucket
+void SpatialHash::Move(uint32_t id, float x, float z)
+{
+	if (BucketOf(x, z) == idBucket[id])
+		return;
+
+	Remove(id);
+	Insert(id, x, z);
+}
+
+/* Fills results with every id in the 3x3 cells around (x, z), anything within
+*  one cell size of the position on both axes is included */
+void SpatialHash::Query(float x, float z, std::vector<uint32_t>& results) const
+{
+	results.clear();
+
+	int32_t cellX = CellOf(x);
+	int32_t cellZ = CellOf(z);
+	uint32_t visited[9];
+	int visitedCount = 0;
+	for (int32_t offsetZ = -1; offsetZ <= 1; offsetZ++)
+	{
+		for (int32_t offsetX = -1; offsetX <= 1; offsetX++)
+		{
+			// Neighbouring cells can hash to the same bucket, only walk it once
+			uint32_t bucket = BucketOfCell(cellX + offsetX, cellZ + offsetZ);
+			bool isVisited = false;
+			for (int i = 0; i < visitedCount; i++)
+				isVisited = isVisited || (visited[i] == bucket);
+			if (isVisited)
+				continue;
+			visited[visitedCount++] = bucket;
+
+			for (uint32_t id = buckets[bucket]; id != SPATIAL_HASH_NONE; id = next[id])
+				results.push_back(id);
+		}
+	}
+}
+
+/* Same as Query for every point in the box, anything within one cell size of the box on both axes
+*  is included. Used for swept tests where the box covers the whole movement */
+void SpatialHash::QueryBox(float minX, float minZ, float maxX, float maxZ, std::vector<uint32_t>& results) const
+{
+	results.clear();
+
+	int32_t firstX = CellOf(minX) - 1;
+	int32_t firstZ = CellOf(minZ) - 1;
+	int32_t lastX = CellOf(maxX) + 1;
+	int32_t lastZ = CellOf(maxZ) + 1;
+
+	// Every bucket once, a box covering more cells than there are buckets walks all of them
+	boxBuckets.clear();
+	if (static_cast<uint64_t>(lastX - firstX + 1) * static_cast<uint64_t>(lastZ - firstZ + 1) >= buckets.size())
+	{
+		for (uint32_t bucket = 0; bucket < buckets.size(); bucket++)
+			boxBuckets.push_back(bucket);
+	}
+	else
+	{
+		for (int32_t cellZ = firstZ; cellZ <= lastZ; cellZ++)
+		{
+			for (int32_t cellX = firstX; cellX <= lastX; cellX++)
+				boxBuckets.push_back(BucketOfCell(cellX, cellZ));
+		}
+		std::sort(boxBuckets.begin(), boxBuckets.end());
+		boxBuckets.erase(std::unique(boxBuckets.begin(), boxBuckets.end()), boxBuckets.end());
+	}
+
+	for (size_t i = 0; i < boxBuckets.size(); i++)
+	{
+		for (uint32_t id = buckets[boxBuckets[i]]; id != SPATIAL_HASH_NONE; id = next[id])
+			results.push_back(id);
+	}
+}
+
+float SpatialHash::GetCellSize() const
+{
+	return cellSize;
+}
+
+size_t SpatialHash::GetBucketCount() const
+{
+	return buckets.size();
+}
+
+size_t SpatialHash::GetIdCount() const
+{
+	return idBucket.size();
+}
+
+uint32_t SpatialHash::BucketOf(float x, float z) const
+{
+	return BucketOfCell(CellOf(x), CellOf(z));
+}
+
+uint32_t SpatialHash::BucketOfCell(int32_t cellX, int32_t cellZ) const
+{
+	// Large primes spread neighbouring cells over the buckets
+	uint32_t hash = (static_cast<uint32_t>(cellX) * 73856093u) ^ (static_cast<uint32_t>(cellZ) * 19349663u);
+	return hash & bucketMask;
+}
+
+// Same as floorf(position / cellSize) without the library call
+int32_t SpatialHash::CellOf(float position) const
+{
+	float scaled = position * inverseCellSize;
+	int32_t cell = static_cast<int32_t>(scaled);
+	return (scaled < static_cast<float>(cell)) ? cell - 1 : cell;
+}
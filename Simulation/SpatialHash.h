@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+constexpr uint32_t SPATIAL_HASH_NONE = 0xFFFFFFFF; // End of a bucket list
+
+/* Uniform grid over the ground plane (x, z) hashed into a fixed number of buckets.
+*
+*  Points are identified by ids from 0 to the id count given to Clear, and kept in a linked
+*  list per bucket so inserting, removing and moving a point is constant time.
+*  Different cells can share a bucket, so Query returns candidates that the caller tests. */
+class SpatialHash
+{
+public:
+	SpatialHash(float cellSize);
+
+	void Clear(size_t idCount);
+	void Insert(uint32_t id, float x, float z);
+	void Remove(uint32_t id);
+	void Move(uint32_t id, float x, float z);
+	void Query(float x, float z, std::vector<uint32_t>& results) const;
+	void QueryBox(float minX, float minZ, float maxX, float maxZ, std::vector<uint32_t>& results) const;
+
+	float GetCellSize() const;
+	size_t GetBucketCount() const;
+	size_t GetIdCount() const;
+
+private:
+	uint32_t BucketOf(float x, float z) const;
+	uint32_t BucketOfCell(int32_t cellX, int32_t cellZ) const;
+	int32_t CellOf(float position) const;
+
+	float cellSize;
+	float inverseCellSize;
+	uint32_t bucketMask = 0;
+
+	std::vector<uint32_t> buckets;  // First id in every bucket
+	std::vector<uint32_t> idBucket; // Bucket every id is linked into, SPATIAL_HASH_NONE when not inserted
+	std::vector<uint32_t> next;     // Doubly linked list of ids within a bucket
+	std::vector<uint32_t> previous;
+
+	mutable std::vector<uint32_t> boxBuckets; // Buckets visited by QueryBox
+};
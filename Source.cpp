@@ -12,6 +12,10 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 		return -1;
 	}
 
+	// Start with the profiler running to also capture the models loading, "-profile" on the command line
+	if (wcsstr(lpCmdLine, L"-profile") != nullptr)
+		Profiler::SetEnabled(true);
+
 	Engine engine;
 	if (engine.Initialize(hInstance, "My Window", "MyWindowClass", 3440, 1400)) // 3440, 1400 1920, 1080
 	{
@@ -20,6 +24,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 			engine.Update();
 			engine.RenderFrame();
 		}
+		engine.SaveInputLog("last_session.s3di");
 	}
 	return 0;
 }
\ No newline at end of file
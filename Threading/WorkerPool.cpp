@@ -0,0 +1,128 @@
+#include "WorkerPool.h"
+#include <algorithm>
+#include <string>
+
+#include "../Profiler/Profiler.h"
+
+WorkerPool::WorkerPool(unsigned int workerCount)
+	: nextChunk(0), finishedChunks(0)
+{
+	threads.reserve(workerCount);
+	for (unsigned int i = 0; i < workerCount; i++)
+		threads.push_back(std::thread(&WorkerPool::WorkerLoop, this, i));
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+/* Calls function for every chunk of chunkSize items and waits for all of them.
+*  Runs everything on the calling thread when there are no workers or only one chunk */
+void WorkerPool::ParallelFor(size_t count, size_t chunkSize, WorkerFunction function, void* context)
+{
+	if (count == 0)
+		return;
+	if (chunkSize == 0)
+		chunkSize = 1;
+
+	if (threads.empty() || count <= chunkSize)
+	{
+		function(context, 0, count);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		// A worker still leaving the last job would take chunks of this one with the old function
+		while (busyWorkers > 0)
+			done.wait(lock);
+
+		this->function = function;
+		this->context = context;
+		this->count = count;
+		this->chunkSize = chunkSize;
+		chunkCount = (count + chunkSize - 1) / chunkSize;
+		nextChunk.store(0);
+		finishedChunks.store(0);
+		generation++;
+	}
+	wake.notify_all();
+
+	RunChunks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (finishedChunks.load() < chunkCount)
+		done.wait(lock);
+}
+
+// Workers plus the calling thread
+unsigned int WorkerPool::GetThreadCount() const
+{
+	return static_cast<unsigned int>(threads.size()) + 1;
+}
+
+// One worker per core besides the one of the calling thread
+unsigned int WorkerPool::DefaultWorkerCount()
+{
+	unsigned int cores = std::thread::hardware_concurrency();
+	return (cores > 1) ? cores - 1 : 0;
+}
+
+void WorkerPool::WorkerLoop(unsigned int index)
+{
+	std::string name = "Worker " + std::to_string(index);
+	Profiler::SetThreadName(name.c_str());
+
+	uint64_t seen = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!stopping && generation == seen)
+				wake.wait(lock);
+			if (stopping)
+				return;
+
+			seen = generation;
+			busyWorkers++;
+		}
+
+		RunChunks();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			busyWorkers--;
+		}
+		done.notify_all();
+	}
+}
+
+// Takes chunks of the current job until there are none left
+void WorkerPool::RunChunks()
+{
+	while (true)
+	{
+		size_t chunk = nextChunk.fetch_add(1);
+		if (chunk >= chunkCount)
+			return;
+
+		size_t begin = chunk * chunkSize;
+		size_t end = std::min(begin + chunkSize, count);
+		function(context, begin, end);
+
+		// Locked so the notify can not slip in between the caller testing the count and waiting
+		if (finishedChunks.fetch_add(1) + 1 == chunkCount)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			done.notify_all();
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs the items from begin up to (not including) end, context is passed through from ParallelFor
+typedef void (*WorkerFunction)(void* context, size_t begin, size_t end);
+
+/* Fixed set of threads that split a range of items into chunks and run them in parallel.
+*
+*  The thread calling ParallelFor works on chunks as well and returns once every chunk is done,
+*  so the caller can read the results right away. Which thread runs a chunk changes from call
+*  to call, functions must only write to the items of their own chunk. */
+class WorkerPool
+{
+public:
+	WorkerPool(unsigned int workerCount = DefaultWorkerCount());
+	~WorkerPool();
+
+	void ParallelFor(size_t count, size_t chunkSize, WorkerFunction function, void* context);
+	unsigned int GetThreadCount() const;
+
+	static unsigned int DefaultWorkerCount();
+
+private:
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	void WorkerLoop(unsigned int index);
+	void RunChunks();
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake; // New job or shutting down
+	std::condition_variable done; // Job finished or a worker left it
+	uint64_t generation = 0;      // Number of jobs started, workers wake when it changes
+	unsigned int busyWorkers = 0; // Workers that picked up the current job and have not left it
+	bool stopping = false;
+
+	// Current job, only written while no worker is busy
+	WorkerFunction function = nullptr;
+	void* context = nullptr;
+	size_t count = 0;
+	size_t chunkSize = 1;
+	size_t chunkCount = 0;
+	std::atomic<size_t> nextChunk;
+	std::atomic<size_t> finishedChunks;
+};
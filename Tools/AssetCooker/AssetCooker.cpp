@@ -0,0 +1,303 @@
+/*
+*  Cooks every model under a data directory into the .mesh files the game maps at startup, and
+*  writes a manifest with the content hash of every model and texture it found.
+*
+*  Built by Tools/AssetCooker/AssetCooker.vcxproj, which Snake3D.vcxproj references so it builds
+*  with the game, and by Tools/CMakeLists.txt. By hand, from the repository root (DirectXMath is
+*  header only, on Linux it also needs sal.h from DirectX-Headers):
+*    g++ -std=c++14 -O2 -I. -I<DirectXMath>/Inc Tools/AssetCooker/AssetCooker.cpp Assets/MeshImport.cpp Assets/MeshOptimizer.cpp Assets/TangentFrames.cpp Assets/CookedMesh.cpp Assets/MappedFile.cpp Threading/WorkerPool.cpp Profiler/Profiler.cpp -lassimp -lpthread
+*    cl /std:c++14 /O2 /EHsc /I. /IIncludes Tools\AssetCooker\AssetCooker.cpp Assets\MeshImport.cpp Assets\MeshOptimizer.cpp Assets\TangentFrames.cpp Assets\CookedMesh.cpp Assets\MappedFile.cpp Threading\WorkerPool.cpp Profiler\Profiler.cpp assimp-vc140-mt.lib
+*
+*  Usage: AssetCooker [data directory] [--force]
+*  The data directory defaults to Data/Objects. A model is only cooked again when its contents
+*  changed since it was last cooked, or when the cooked format changed; --force cooks every model.
+*  Models are only hashed when their size or last write time changed. The game cooks the models
+*  it has to import itself, running this ahead of time spares the first start that import.
+*  Textures stay in their own files, the game loads them as they are, they are only hashed.
+*  Exits with 1 if a model failed to cook.
+*/
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "Assets/CookedMesh.h"
+#include "Assets/MeshImport.h"
+#include "Threading/WorkerPool.h"
+
+constexpr const char* MANIFEST_NAME = "cooked_manifest.txt";
+constexpr int MANIFEST_VERSION = 1;
+
+enum class AssetKind
+{
+	Model,
+	Texture
+};
+
+enum class CookResult
+{
+	Hashed,   // Textures
+	UpToDate,
+	Cooked,
+	Failed
+};
+
+struct Asset
+{
+	std::string path; // Relative to the data directory, '/' separated
+	AssetKind kind = AssetKind::Model;
+	uint64_t size = 0;
+	uint64_t hash = 0;
+	CookResult result = CookResult::Failed;
+	MeshOptimizeStats stats;
+};
+
+struct CookJob
+{
+	std::string root;
+	std::vector<Asset>* assets;
+	bool force;
+};
+
+static std::string GetExtension(const std::string& fileName)
+{
+	size_t dot = fileName.find_last_of('.');
+	if (dot == std::string::npos)
+		return "";
+
+	std::string extension = fileName.substr(dot + 1);
+	for (size_t i = 0; i < extension.size(); i++)
+		extension[i] = static_cast<char>(tolower(static_cast<unsigned char>(extension[i])));
+	return extension;
+}
+
+// Only the formats the game loads, the .blend next to the nanosuit is left alone
+static bool GetKind(const std::string& fileName, AssetKind& kind)
+{
+	std::string extension = GetExtension(fileName);
+	if (extension == "fbx" || extension == "obj")
+	{
+		kind = AssetKind::Model;
+		return true;
+	}
+	if (extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "dds" || extension == "tga" || extension == "bmp")
+	{
+		kind = AssetKind::Texture;
+		return true;
+	}
+	return false;
+}
+
+static void AddFile(const std::string& relativePath, const std::string& fileName, std::vector<Asset>& assets)
+{
+	Asset asset;
+	if (!GetKind(fileName, asset.kind))
+		return;
+
+	asset.path = relativePath;
+	assets.push_back(asset);
+}
+
+// Adds the models and textures in the directory and every directory below it
+static void FindAssets(const std::string& root, const std::string& relativeDirectory, std::vector<Asset>& assets)
+{
+	std::string directory = relativeDirectory.empty() ? root : root + "/" + relativeDirectory;
+	std::string prefix = relativeDirectory.empty() ? "" : relativeDirectory + "/";
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA entry;
+	HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &entry);
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		std::string name = entry.cFileName;
+		if (name == "." || name == "..")
+			continue;
+
+		if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			FindAssets(root, prefix + name, assets);
+		else
+			AddFile(prefix + name, name, assets);
+	} while (FindNextFileA(find, &entry));
+	FindClose(find);
+#else
+	DIR* dir = opendir(directory.c_str());
+	if (dir == nullptr)
+		return;
+
+	while (dirent* entry = readdir(dir))
+	{
+		std::string name = entry->d_name;
+		if (name == "." || name == "..")
+			continue;
+
+		struct stat status;
+		if (stat((directory + "/" + name).c_str(), &status) != 0)
+			continue;
+
+		if (S_ISDIR(status.st_mode))
+			FindAssets(root, prefix + name, assets);
+		else if (S_ISREG(status.st_mode))
+			AddFile(prefix + name, name, assets);
+	}
+	closedir(dir);
+#endif
+}
+
+static bool PathBefore(const Asset& a, const Asset& b)
+{
+	return a.path < b.path;
+}
+
+static void Cook(const CookJob& job, Asset& asset)
+{
+	std::string filePath = job.root + "/" + asset.path;
+	if (asset.kind == AssetKind::Texture)
+	{
+		asset.result = CookedMesh::HashFile(filePath, asset.size, asset.hash) ? CookResult::Hashed : CookResult::Failed;
+		return;
+	}
+
+	uint64_t sourceTime = 0;
+	if (!CookedMesh::GetFileStamp(filePath, asset.size, sourceTime))
+	{
+		asset.result = CookResult::Failed;
+		return;
+	}
+
+	// The cooked file knows which file it came from, no separate state is needed to cook incrementally.
+	// An unchanged model is not read at all, the manifest takes the hash it was cooked with
+	std::string cookedPath = CookedMesh::GetCookedPath(filePath);
+	bool hashed = false;
+	if (!job.force)
+	{
+		CookedMeshFile cooked;
+		if (cooked.Open(cookedPath))
+		{
+			if (cooked.IsStampedFrom(asset.size, sourceTime))
+			{
+				asset.hash = cooked.GetHeader().sourceHash;
+				asset.result = CookResult::UpToDate;
+				return;
+			}
+
+			// A touched or freshly checked out model with the cooked contents only needs the new time
+			hashed = CookedMesh::HashFile(filePath, asset.size, asset.hash);
+			bool sameContents = hashed && cooked.IsCookedFrom(asset.size, asset.hash);
+			cooked.Close();
+			if (sameContents)
+			{
+				asset.result = CookedMesh::Stamp(cookedPath, sourceTime) ? CookResult::UpToDate : CookResult::Failed;
+				return;
+			}
+		}
+	}
+
+	ModelData model;
+	if ((!hashed && !CookedMesh::HashFile(filePath, asset.size, asset.hash)) || !MeshImport::Import(filePath, model) ||
+		!CookedMesh::Write(cookedPath, model, asset.size, asset.hash, sourceTime))
+	{
+		asset.result = CookResult::Failed;
+		return;
+	}
+	asset.stats = model.stats;
+	asset.result = CookResult::Cooked;
+}
+
+// One asset per chunk, a single large model must not hold up the files queued behind it
+static void CookChunk(void* context, size_t begin, size_t end)
+{
+	const CookJob& job = *static_cast<const CookJob*>(context);
+	for (size_t i = begin; i < end; i++)
+		Cook(job, (*job.assets)[i]);
+}
+
+/* One line per asset, sorted by path so the manifest only changes when an asset does:
+*  <model|texture> <FNV-1a hash> <size> <path> [cooked path] */
+static bool WriteManifest(const std::string& root, const std::vector<Asset>& assets)
+{
+	std::ofstream file(root + "/" + MANIFEST_NAME, std::ios::trunc);
+	if (!file)
+		return false;
+
+	file << "Snake3D assets " << MANIFEST_VERSION << " mesh format " << COOKED_MESH_VERSION << "\n";
+	for (size_t i = 0; i < assets.size(); i++)
+	{
+		const Asset& asset = assets[i];
+		if (asset.result == CookResult::Failed)
+			continue;
+
+		char hash[17];
+		snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(asset.hash));
+		file << ((asset.kind == AssetKind::Model) ? "model " : "texture ") << hash << " " << asset.size << " " << asset.path;
+		if (asset.kind == AssetKind::Model)
+			file << " " << CookedMesh::GetCookedPath(asset.path);
+		file << "\n";
+	}
+	return static_cast<bool>(file);
+}
+
+int main(int argc, char** argv)
+{
+	std::string root = "Data/Objects";
+	bool force = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--force") == 0)
+			force = true;
+		else
+			root = argv[i];
+	}
+
+	std::vector<Asset> assets;
+	FindAssets(root, "", assets);
+	if (assets.empty())
+	{
+		printf("No models or textures found in %s\n", root.c_str());
+		return 1;
+	}
+	std::sort(assets.begin(), assets.end(), PathBefore);
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	WorkerPool workers;
+	CookJob job = { root, &assets, force };
+	workers.ParallelFor(assets.size(), 1, CookChunk, &job);
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	size_t counts[4] = {};
+	for (size_t i = 0; i < assets.size(); i++)
+	{
+		const Asset& asset = assets[i];
+		counts[static_cast<int>(asset.result)]++;
+		if (asset.result == CookResult::Cooked)
+			printf("%-9s %s | %u vertices welded to %u for %u triangles | ACMR %.3f -> %.3f\n", "cooked", asset.path.c_str(),
+				asset.stats.sourceVertices, asset.stats.vertices, asset.stats.triangles, asset.stats.acmrBefore, asset.stats.acmrAfter);
+		else if (asset.result == CookResult::Failed)
+			printf("%-9s %s\n", "FAILED", asset.path.c_str());
+	}
+
+	if (!WriteManifest(root, assets))
+	{
+		printf("Failed to write %s/%s\n", root.c_str(), MANIFEST_NAME);
+		return 1;
+	}
+
+	printf("%zu cooked | %zu up to date | %zu failed | %zu textures | %u threads %.1f ms\n",
+		counts[static_cast<int>(CookResult::Cooked)], counts[static_cast<int>(CookResult::UpToDate)],
+		counts[static_cast<int>(CookResult::Failed)], counts[static_cast<int>(CookResult::Hashed)],
+		workers.GetThreadCount(), milliseconds);
+	return (counts[static_cast<int>(CookResult::Failed)] > 0) ? 1 : 0;
+}
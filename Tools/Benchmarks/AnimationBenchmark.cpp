@@ -0,0 +1,115 @@
+/*
+*  Updates 1k, 10k and 100k animations with the AnimationSystem on the calling thread and split
+*  across a WorkerPool, and checks that both end with exactly the same transforms.
+*
+*  Builds on Windows without the game, from the repository root (Includes is the game's include directory):
+*    cl /std:c++14 /O2 /EHsc /I. /IIncludes Tools\Benchmarks\AnimationBenchmark.cpp Animation\Animation.cpp Threading\WorkerPool.cpp Profiler\Profiler.cpp Graphics\GameObject.cpp Graphics\GameObject3D.cpp
+*
+*  Every object has a position animation, every second one a continous rotation and every fourth one
+*  a scale animation, with lengths spread so animations finish and are removed during the run.
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Animation/Animation.h"
+#include "Graphics/GameObject3D.h"
+#include "Threading/WorkerPool.h"
+
+constexpr float FRAME_LENGTH = 1000.0f / 115.0f; // Miliseconds
+constexpr int FRAMES = 200;
+
+// Same matrix work as RenderableGameObject without a model
+class BenchmarkObject : public GameObject3D
+{
+public:
+	BenchmarkObject()
+	{
+		SetPosition(0.0f, 0.0f, 0.0f);
+		SetRotation(0.0f, 0.0f, 0.0f);
+		SetScale(1.0f, 1.0f, 1.0f);
+	}
+
+protected:
+	void UpdateMatrix() override
+	{
+		worldMatrix = XMMatrixScaling(scale.x, scale.y, scale.z) * XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z) * XMMatrixTranslation(pos.x, pos.y, pos.z);
+	}
+
+	XMMATRIX worldMatrix;
+};
+
+static void CreateAnimations(AnimationSystem& system, std::vector<BenchmarkObject>& objects)
+{
+	system.Reserve(objects.size());
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		float spread = static_cast<float>(i % 97);
+		AnimationEasing easing = static_cast<AnimationEasing>(i % 4);
+
+		system.Start(system.CreateAnimation(&objects[i], AnimationType::Position, 200.0f + spread, XMFLOAT3(spread, 0.0f, 100.0f + spread), false, easing));
+		if (i % 2 == 0)
+			system.Start(system.CreateAnimation(&objects[i], AnimationType::Rotation, 1.0f + (spread * 0.01f), XMFLOAT3(0.0f, XM_2PI, 0.0f), true));
+		if (i % 4 == 0)
+			system.Start(system.CreateAnimation(&objects[i], AnimationType::Scale, 0.5f, XMFLOAT3(spread * 0.01f, spread * 0.01f, spread * 0.01f), false, easing));
+	}
+}
+
+static double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static double Run(AnimationSystem& system)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	Clock::time_point start = Clock::now();
+	for (int frame = 0; frame < FRAMES; frame++)
+		system.Update(FRAME_LENGTH);
+	return Milliseconds(Clock::now() - start) / FRAMES;
+}
+
+static bool SameTransform(const GameObject& a, const GameObject& b)
+{
+	return memcmp(&a.GetPositionFloat3(), &b.GetPositionFloat3(), sizeof(XMFLOAT3)) == 0 &&
+	       memcmp(&a.GetRotationFloat3(), &b.GetRotationFloat3(), sizeof(XMFLOAT3)) == 0 &&
+	       memcmp(&a.GetScaleFloat3(), &b.GetScaleFloat3(), sizeof(XMFLOAT3)) == 0;
+}
+
+static void Compare(size_t objectCount, WorkerPool& workers)
+{
+	std::vector<BenchmarkObject> singleObjects(objectCount);
+	std::vector<BenchmarkObject> parallelObjects(objectCount);
+
+	AnimationSystem single;
+	AnimationSystem parallel;
+	parallel.SetWorkerPool(&workers);
+	CreateAnimations(single, singleObjects);
+	CreateAnimations(parallel, parallelObjects);
+	size_t animations = single.GetAnimationCount();
+
+	double singleTime = Run(single);
+	double parallelTime = Run(parallel);
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < objectCount; i++)
+	{
+		if (!SameTransform(singleObjects[i], parallelObjects[i]))
+			mismatches++;
+	}
+
+	printf("%7zu objects %7zu animations | one thread %8.4f ms | %u threads %8.4f ms | x%5.2f | %s | left %zu/%zu | mismatches %zu\n",
+		objectCount, animations, singleTime, workers.GetThreadCount(), parallelTime, singleTime / parallelTime,
+		(animations < ANIMATION_PARALLEL_THRESHOLD) ? "inline " : "workers", single.GetAnimationCount(), parallel.GetAnimationCount(), mismatches);
+}
+
+int main()
+{
+	WorkerPool workers;
+	printf("Per update cost, average of %d updates\n", FRAMES);
+	Compare(1000, workers);
+	Compare(10000, workers);
+	Compare(100000, workers);
+	return 0;
+}
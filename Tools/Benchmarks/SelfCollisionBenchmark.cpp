@@ -0,0 +1,135 @@
+/*
+*  Compares the head vs body self collision test done with a linear scan over every
+*  segment against the hashed trail in SelfCollisionHash, at 1k, 10k and 100k segments.
+*
+*  Builds without the game, from the repository root:
+*    g++ -std=c++14 -O2 -I. Tools/Benchmarks/SelfCollisionBenchmark.cpp Simulation/SnakeBody.cpp Simulation/SnakeTrail.cpp Simulation/SpatialHash.cpp Simulation/SelfCollisionHash.cpp
+*    cl /std:c++14 /O2 /EHsc /I. Tools\Benchmarks\SelfCollisionBenchmark.cpp Simulation\SnakeBody.cpp Simulation\SnakeTrail.cpp Simulation\SpatialHash.cpp Simulation\SelfCollisionHash.cpp
+*
+*  Every tick the head and one point on the body are tested, both ways must find the same segment.
+*/
+#include <chrono>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "Simulation/SelfCollisionHash.h"
+#include "Simulation/SnakeBody.h"
+#include "Simulation/SnakeSimulation.h"
+
+constexpr float TICK_LENGTH = 1000.0f / 120.0f; // Miliseconds, same as the default simulation tick rate
+constexpr int TICKS = 200;
+
+struct Head
+{
+	SimFloat3 position;
+	float yaw = 0.0f;
+	float sinceTurn = 0.0f;
+	bool turnRight = true;
+
+	// Staircase path, turns 90 degrees every 2000 units alternating left and right
+	void Move(float distance)
+	{
+		position = position + (SimForwardFromYaw(yaw) * distance);
+		sinceTurn += distance;
+		if (sinceTurn >= 2000.0f)
+		{
+			yaw += turnRight ? SIM_PIDIV2 : -SIM_PIDIV2;
+			turnRight = !turnRight;
+			sinceTurn = 0.0f;
+		}
+	}
+};
+
+// Same test the simulation used to do for every segment
+static int LinearScan(float x, float z, const SnakeBody& body)
+{
+	const float* bodyX = body.GetPositionX();
+	const float* bodyZ = body.GetPositionZ();
+	for (size_t i = 0; i < body.Size(); i++)
+	{
+		if (fabsf(x - bodyX[i]) < SELF_COLLISION_RADIUS && fabsf(z - bodyZ[i]) < SELF_COLLISION_RADIUS)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+static double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static void Run(size_t segments)
+{
+	SnakeTrail trail(SNAKE_SEGMENT_SPACING / 8.0f);
+	Head head;
+	trail.Reset(head.position, head.yaw);
+	trail.Reserve(SNAKE_SEGMENT_SPACING * (segments + 1));
+
+	float distancePerTick = (SNAKE_START_SPEED / 100.0f) * TICK_LENGTH;
+	for (float travelled = 0.0f; travelled < SNAKE_SEGMENT_SPACING * (segments + 1); travelled += distancePerTick)
+	{
+		head.Move(distancePerTick);
+		trail.Advance(head.position, head.yaw);
+	}
+
+	SnakeBody body;
+	for (size_t i = 0; i < segments; i++)
+		body.Add(SimFloat3(), 0.0f);
+	body.Follow(trail, SNAKE_SEGMENT_SPACING);
+
+	SelfCollisionHash hash(SNAKE_SEGMENT_SPACING);
+	hash.Update(trail, body.Size());
+
+	typedef std::chrono::high_resolution_clock Clock;
+	Clock::duration linearTime(0), updateTime(0), queryTime(0);
+	int mismatches = 0;
+	int hits = 0;
+
+	for (int tick = 0; tick < TICKS; tick++)
+	{
+		head.Move(distancePerTick);
+		trail.Advance(head.position, head.yaw);
+		body.Follow(trail, SNAKE_SEGMENT_SPACING);
+
+		// A point right next to a segment somewhere along the body
+		size_t target = (static_cast<size_t>(tick) * 7919) % segments;
+		SnakeSegment segment = body.GetSegment(target);
+		float probeX = segment.position.x + 10.0f;
+		float probeZ = segment.position.z - 10.0f;
+
+		Clock::time_point start = Clock::now();
+		int linearHead = LinearScan(head.position.x, head.position.z, body);
+		int linearProbe = LinearScan(probeX, probeZ, body);
+		Clock::time_point scanned = Clock::now();
+		hash.Update(trail, body.Size());
+		Clock::time_point updated = Clock::now();
+		int hashHead = hash.Query(head.position, SELF_COLLISION_RADIUS, trail, body);
+		int hashProbe = hash.Query(SimFloat3(probeX, 0.0f, probeZ), SELF_COLLISION_RADIUS, trail, body);
+		Clock::time_point queried = Clock::now();
+
+		linearTime += scanned - start;
+		updateTime += updated - scanned;
+		queryTime += queried - updated;
+		if (linearHead != hashHead || linearProbe != hashProbe)
+			mismatches++;
+		if (hashProbe >= 0)
+			hits++;
+	}
+
+	// Two queries per tick, times are for one
+	double linear = Milliseconds(linearTime) / (TICKS * 2);
+	double update = Milliseconds(updateTime) / TICKS;
+	double query = Milliseconds(queryTime) / (TICKS * 2);
+	printf("%7zu segments | linear scan %8.4f ms | hash update %8.4f ms | hash query %8.5f ms | hits %d/%d | mismatches %d\n",
+		segments, linear, update, query, hits, TICKS, mismatches);
+}
+
+int main()
+{
+	printf("Per tick cost, average of %d ticks\n", TICKS);
+	Run(1000);
+	Run(10000);
+	Run(100000);
+	return 0;
+}
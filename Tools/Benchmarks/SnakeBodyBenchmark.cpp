@@ -0,0 +1,151 @@
+/*
+*  Measures the per tick cost of moving the snake body and building its world matrices
+*  at 1k, 10k and 100k segments.
+*
+*  Builds without the game, from the repository root:
+*    g++ -std=c++14 -O2 -I. Tools/Benchmarks/SnakeBodyBenchmark.cpp Simulation/SnakeBody.cpp Simulation/SnakeTrail.cpp
+*    cl /std:c++14 /O2 /EHsc /I. Tools\Benchmarks\SnakeBodyBenchmark.cpp Simulation\SnakeBody.cpp Simulation\SnakeTrail.cpp
+*
+*  "per segment" is a scalar reference over an array of SnakeSegment structs: one SnakeTrail::Sample
+*  call, one interpolation with SimLerp and SimLerpAngle and one sinf/cosf per segment, written to
+*  its own matrices. It has none of the heap objects, virtual UpdateMatrix calls or cached direction
+*  vectors of the old per object RenderableGameObject path, so it is a lower bound of what that cost.
+*  "worst difference" is the largest difference of any matrix element between the two.
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "Simulation/SnakeBody.h"
+#include "Simulation/SnakeSimulation.h"
+
+constexpr float TICK_LENGTH = 1000.0f / 120.0f; // Miliseconds, same as the default simulation tick rate
+constexpr int TICKS = 200;
+
+struct Head
+{
+	SimFloat3 position;
+	float yaw = 0.0f;
+	float sinceTurn = 0.0f;
+	bool turnRight = true;
+
+	// Staircase path, turns 90 degrees every 2000 units alternating left and right
+	void Move(float distance)
+	{
+		position = position + (SimForwardFromYaw(yaw) * distance);
+		sinceTurn += distance;
+		if (sinceTurn >= 2000.0f)
+		{
+			yaw += turnRight ? SIM_PIDIV2 : -SIM_PIDIV2;
+			turnRight = !turnRight;
+			sinceTurn = 0.0f;
+		}
+	}
+};
+
+static double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static float MatrixDifference(const SimMatrix& a, const SimMatrix& b)
+{
+	float worst = 0.0f;
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+			worst = fmaxf(worst, fabsf(a.m[row][column] - b.m[row][column]));
+	}
+	return worst;
+}
+
+static void Run(size_t segments)
+{
+	SnakeTrail trail(SNAKE_SEGMENT_SPACING / 8.0f);
+	Head head;
+	trail.Reset(head.position, head.yaw);
+	trail.Reserve(SNAKE_SEGMENT_SPACING * (segments + 1));
+
+	// Lay down a full length trail before measuring
+	float distancePerTick = (SNAKE_START_SPEED / 100.0f) * TICK_LENGTH;
+	for (float travelled = 0.0f; travelled < SNAKE_SEGMENT_SPACING * (segments + 1); travelled += distancePerTick)
+	{
+		head.Move(distancePerTick);
+		trail.Advance(head.position, head.yaw);
+	}
+
+	SnakeBody body;
+	body.Reserve(segments);
+	for (size_t i = 0; i < segments; i++)
+		body.Add(SimFloat3(), 0.0f);
+	body.Follow(trail, SNAKE_SEGMENT_SPACING);
+	SnakeBody previousBody = body;
+
+	std::vector<SimMatrix> matrices(segments);
+	std::vector<SimMatrix> referenceMatrices(segments);
+	std::vector<SnakeSegment> segmentList(segments);
+	std::vector<SnakeSegment> previousSegmentList(segments);
+	for (size_t i = 0; i < segments; i++)
+		segmentList[i] = body.GetSegment(i);
+
+	typedef std::chrono::high_resolution_clock Clock;
+	Clock::duration followTime(0), matrixTime(0), perSegmentTime(0);
+	float worstDifference = 0.0f;
+
+	for (int tick = 0; tick < TICKS; tick++)
+	{
+		head.Move(distancePerTick);
+		trail.Advance(head.position, head.yaw);
+
+		Clock::time_point start = Clock::now();
+		std::swap(previousBody, body);
+		body.Resize(previousBody.Size());
+		body.Follow(trail, SNAKE_SEGMENT_SPACING);
+		Clock::time_point followed = Clock::now();
+		body.BuildWorldMatrices(previousBody, 0.5f, matrices.data());
+		Clock::time_point built = Clock::now();
+
+		std::swap(previousSegmentList, segmentList);
+		for (size_t i = 0; i < segments; i++)
+		{
+			TrailSample sample = trail.Sample(SNAKE_SEGMENT_SPACING * (i + 1));
+			segmentList[i].position = sample.position;
+			segmentList[i].yaw = sample.yaw;
+
+			SimFloat3 position = SimLerp(previousSegmentList[i].position, segmentList[i].position, 0.5f);
+			float yaw = SimLerpAngle(previousSegmentList[i].yaw, segmentList[i].yaw, 0.5f);
+			float s = sinf(yaw);
+			float c = cosf(yaw);
+			SimMatrix& matrix = referenceMatrices[i];
+			matrix.m[0][0] = c; matrix.m[0][1] = 0.0f; matrix.m[0][2] = -s; matrix.m[0][3] = 0.0f;
+			matrix.m[1][0] = 0.0f; matrix.m[1][1] = 1.0f; matrix.m[1][2] = 0.0f; matrix.m[1][3] = 0.0f;
+			matrix.m[2][0] = s; matrix.m[2][1] = 0.0f; matrix.m[2][2] = c; matrix.m[2][3] = 0.0f;
+			matrix.m[3][0] = position.x; matrix.m[3][1] = position.y; matrix.m[3][2] = position.z; matrix.m[3][3] = 1.0f;
+		}
+		Clock::time_point perSegment = Clock::now();
+
+		followTime += followed - start;
+		matrixTime += built - followed;
+		perSegmentTime += perSegment - built;
+
+		for (size_t i = 0; i < segments; i++)
+			worstDifference = fmaxf(worstDifference, MatrixDifference(matrices[i], referenceMatrices[i]));
+	}
+
+	double follow = Milliseconds(followTime) / TICKS;
+	double matrix = Milliseconds(matrixTime) / TICKS;
+	double old = Milliseconds(perSegmentTime) / TICKS;
+	printf("%7zu segments | follow %8.4f ms (%4.1f%%) | matrices %8.4f ms | total %8.4f ms | per segment %8.4f ms | worst difference %g\n",
+		segments, follow, (follow * 100.0) / (follow + matrix), matrix, follow + matrix, old, worstDifference);
+}
+
+int main()
+{
+	printf("Per tick cost, average of %d ticks\n", TICKS);
+	Run(1000);
+	Run(10000);
+	Run(100000);
+	return 0;
+}
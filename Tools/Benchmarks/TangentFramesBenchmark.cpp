@@ -0,0 +1,320 @@
+/*
+*  Compares TangentFrames::Generate against a plain scalar loop doing the same sums one triangle
+*  and one vertex at a time, on UV spheres of 1k, 16k and 260k vertices and on a mesh made only of
+*  broken triangles.
+*
+*  Builds without the game or D3D, from the repository root (DirectXMath is header only, on Linux
+*  it also needs sal.h from DirectX-Headers):
+*    g++ -std=c++14 -O2 -I. -I<DirectXMath>/Inc Tools/Benchmarks/TangentFramesBenchmark.cpp Assets/TangentFrames.cpp Profiler/Profiler.cpp -lpthread
+*    cl /std:c++14 /O2 /EHsc /I. /IIncludes Tools\Benchmarks\TangentFramesBenchmark.cpp Assets\TangentFrames.cpp Profiler\Profiler.cpp
+*
+*  Each sphere is built twice, the second copy with mirrored UVs so half the binormals point the
+*  other way. Every frame has to be finite and orthonormal and lie within FRAME_BOUND degrees of
+*  the scalar one, with the binormal on the same side. Exits with 1 if any frame does not.
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "Assets/TangentFrames.h"
+
+using namespace DirectX;
+
+constexpr float FRAME_BOUND = 0.01f;         // Degrees
+constexpr float ORTHONORMAL_BOUND = 1e-5f;
+constexpr float RADIANS_TO_DEGREES = 57.29577951f;
+constexpr float PI = 3.14159265f;
+constexpr int RUNS = 20;
+
+static int failures = 0;
+
+static float Dot(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+static XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3((a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x));
+}
+
+static XMFLOAT3 Subtract(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static XMFLOAT3 Scale(const XMFLOAT3& a, float s)
+{
+	return XMFLOAT3(a.x * s, a.y * s, a.z * s);
+}
+
+static void Add(XMFLOAT3& sum, const XMFLOAT3& a)
+{
+	sum.x += a.x;
+	sum.y += a.y;
+	sum.z += a.z;
+}
+
+static bool IsFinite(const XMFLOAT3& a)
+{
+	return std::isfinite(a.x) && std::isfinite(a.y) && std::isfinite(a.z);
+}
+
+// Angle between two unit vectors, in double so the measurement adds no error of its own
+static double AngleDegrees(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	double cx = ((double)a.y * b.z) - ((double)a.z * b.y);
+	double cy = ((double)a.z * b.x) - ((double)a.x * b.z);
+	double cz = ((double)a.x * b.y) - ((double)a.y * b.x);
+	double dot = ((double)a.x * b.x) + ((double)a.y * b.y) + ((double)a.z * b.z);
+	return atan2(sqrt((cx * cx) + (cy * cy) + (cz * cz)), dot) * RADIANS_TO_DEGREES;
+}
+
+/* The rules documented in TangentFrames.h written out one triangle and one vertex at a time,
+*  with a division and a square root where they are needed */
+static void ReferenceFrames(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+{
+	std::vector<XMFLOAT3> tangentSums(vertexCount, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	std::vector<XMFLOAT3> binormalSums(vertexCount, XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		const uint32_t* triangle = indices + i;
+		if (triangle[0] >= vertexCount || triangle[1] >= vertexCount || triangle[2] >= vertexCount)
+			continue;
+
+		const Vertex& v0 = vertices[triangle[0]];
+		const Vertex& v1 = vertices[triangle[1]];
+		const Vertex& v2 = vertices[triangle[2]];
+		XMFLOAT3 edge1 = Subtract(v1.pos, v0.pos);
+		XMFLOAT3 edge2 = Subtract(v2.pos, v0.pos);
+		float du1 = v1.texCoord.x - v0.texCoord.x;
+		float dv1 = v1.texCoord.y - v0.texCoord.y;
+		float du2 = v2.texCoord.x - v0.texCoord.x;
+		float dv2 = v2.texCoord.y - v0.texCoord.y;
+
+		float determinant = (du1 * dv2) - (du2 * dv1);
+		float uvLength = (du1 * du1) + (dv1 * dv1) + (du2 * du2) + (dv2 * dv2);
+		if (!(fabsf(determinant) > uvLength * TEXTURE_SPACE_EPSILON))
+			continue;
+
+		float sign = (determinant < 0.0f) ? -1.0f : 1.0f;
+		XMFLOAT3 tangent = Scale(Subtract(Scale(edge1, dv2), Scale(edge2, dv1)), sign);
+		XMFLOAT3 binormal = Scale(Subtract(Scale(edge2, du1), Scale(edge1, du2)), sign);
+		if (!IsFinite(tangent) || !IsFinite(binormal))
+			continue;
+
+		for (size_t k = 0; k < 3; k++)
+		{
+			Add(tangentSums[triangle[k]], tangent);
+			Add(binormalSums[triangle[k]], binormal);
+		}
+	}
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		Vertex& vertex = vertices[i];
+		float normalLength = Dot(vertex.normal, vertex.normal);
+		XMFLOAT3 normal(0.0f, 1.0f, 0.0f);
+		if (normalLength > 1e-24f && std::isfinite(normalLength))
+			normal = Scale(vertex.normal, 1.0f / sqrtf(normalLength));
+
+		const XMFLOAT3& tangentSum = tangentSums[i];
+		XMFLOAT3 tangent = Subtract(tangentSum, Scale(normal, Dot(normal, tangentSum)));
+		if (!(Dot(tangent, tangent) > Dot(tangentSum, tangentSum) * 1e-8f))
+			tangent = (fabsf(normal.x) < 0.9f) ? XMFLOAT3(0.0f, -normal.z, normal.y) : XMFLOAT3(normal.z, 0.0f, -normal.x);
+		tangent = Scale(tangent, 1.0f / sqrtf(Dot(tangent, tangent)));
+
+		XMFLOAT3 binormal = Cross(normal, tangent);
+		if (Dot(binormal, binormalSums[i]) < 0.0f)
+			binormal = Scale(binormal, -1.0f);
+
+		vertex.normal = normal;
+		vertex.tangent = tangent;
+		vertex.biNormal = binormal;
+	}
+}
+
+// Latitude and longitude grid with a seam column, normals point out. Mirrored spheres run u the other way
+static void AddSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, int rings, int sectors, float centerX, bool mirrored)
+{
+	uint32_t first = static_cast<uint32_t>(vertices.size());
+	for (int ring = 0; ring <= rings; ring++)
+	{
+		float v = static_cast<float>(ring) / rings;
+		float polar = v * PI;
+		for (int sector = 0; sector <= sectors; sector++)
+		{
+			float u = static_cast<float>(sector) / sectors;
+			float azimuth = u * 2.0f * PI;
+			float x = sinf(polar) * cosf(azimuth);
+			float y = cosf(polar);
+			float z = sinf(polar) * sinf(azimuth);
+			vertices.push_back(Vertex(centerX + x, y, z, mirrored ? -u : u, v, x, y, z, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+		}
+	}
+
+	uint32_t row = static_cast<uint32_t>(sectors + 1);
+	for (uint32_t ring = 0; ring < static_cast<uint32_t>(rings); ring++)
+	{
+		for (uint32_t sector = 0; sector < static_cast<uint32_t>(sectors); sector++)
+		{
+			uint32_t a = first + (ring * row) + sector;
+			uint32_t b = a + row;
+			uint32_t quad[6] = { a, b, a + 1, a + 1, b, b + 1 };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+}
+
+/* Every way a triangle can fail to have a texture space, and vertices that are left without one.
+*  The counts are not multiples of four, so the partial groups are covered too */
+static void AddBrokenTriangles(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float infinity = std::numeric_limits<float>::infinity();
+	const Vertex corners[] = {
+		// No area
+		Vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0, 0, 0, 0, 0, 0),
+		// UVs in a line
+		Vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(1.0f, 0.0f, 0.0f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0, 0, 0, 0, 0, 0),
+		// Every UV the same
+		Vertex(0.0f, 0.0f, 0.0f, 0.3f, 0.3f, 1.0f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 1.0f, 0.0f, 0.3f, 0.3f, 1.0f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 0.0f, 1.0f, 0.3f, 0.3f, 1.0f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		// NaN UV
+		Vertex(0.0f, 0.0f, 0.0f, nan, 0.0f, 0.0f, 1.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		// Infinite position
+		Vertex(infinity, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		// Good triangle on vertices without a normal or with a NaN one
+		Vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, nan, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1e-20f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		// Normal along the tangent the UVs give, and one along x for the other fallback axis
+		Vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		Vertex(0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0),
+		// Not used by any triangle
+		Vertex(5.0f, 5.0f, 5.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0, 0, 0, 0, 0, 0),
+	};
+
+	uint32_t first = static_cast<uint32_t>(vertices.size());
+	vertices.insert(vertices.end(), corners, corners + (sizeof(corners) / sizeof(corners[0])));
+	for (uint32_t corner = 0; corner < 21; corner++)
+		indices.push_back(first + corner);
+
+	// Index past the last vertex
+	uint32_t outOfRange[3] = { first, first + 1, 0xFFFFFFFF };
+	indices.insert(indices.end(), outOfRange, outOfRange + 3);
+}
+
+static double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static bool IsOrthonormal(const Vertex& vertex)
+{
+	return fabsf(Dot(vertex.normal, vertex.normal) - 1.0f) <= ORTHONORMAL_BOUND &&
+		fabsf(Dot(vertex.tangent, vertex.tangent) - 1.0f) <= ORTHONORMAL_BOUND &&
+		fabsf(Dot(vertex.biNormal, vertex.biNormal) - 1.0f) <= ORTHONORMAL_BOUND &&
+		fabsf(Dot(vertex.normal, vertex.tangent)) <= ORTHONORMAL_BOUND &&
+		fabsf(Dot(vertex.normal, vertex.biNormal)) <= ORTHONORMAL_BOUND &&
+		fabsf(Dot(vertex.tangent, vertex.biNormal)) <= ORTHONORMAL_BOUND;
+}
+
+static void Run(const char* name, const std::vector<Vertex>& source, const std::vector<uint32_t>& indices)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	std::vector<Vertex> generated;
+	std::vector<Vertex> reference;
+	Clock::duration generateTime(0), referenceTime(0);
+
+	for (int run = 0; run < RUNS; run++)
+	{
+		generated = source;
+		Clock::time_point start = Clock::now();
+		TangentFrames::Generate(generated.data(), generated.size(), indices.data(), indices.size());
+		generateTime += Clock::now() - start;
+
+		reference = source;
+		start = Clock::now();
+		ReferenceFrames(reference.data(), reference.size(), indices.data(), indices.size());
+		referenceTime += Clock::now() - start;
+	}
+
+	double worst = 0.0;
+	int notFinite = 0;
+	int notOrthonormal = 0;
+	int flippedSigns = 0;
+	int mirrored = 0; // Frames with the binormal on the other side, half of the sphere vertices
+	for (size_t i = 0; i < generated.size(); i++)
+	{
+		const Vertex& a = generated[i];
+		const Vertex& b = reference[i];
+		if (!IsFinite(a.normal) || !IsFinite(a.tangent) || !IsFinite(a.biNormal))
+		{
+			notFinite++;
+			continue;
+		}
+		if (!IsOrthonormal(a))
+			notOrthonormal++;
+		if (Dot(a.biNormal, b.biNormal) <= 0.0f)
+			flippedSigns++;
+		if (Dot(Cross(a.normal, a.tangent), a.biNormal) < 0.0f)
+			mirrored++;
+		worst = fmax(worst, AngleDegrees(a.normal, b.normal));
+		worst = fmax(worst, AngleDegrees(a.tangent, b.tangent));
+		worst = fmax(worst, AngleDegrees(a.biNormal, b.biNormal));
+	}
+
+	double generateMs = Milliseconds(generateTime) / RUNS;
+	double referenceMs = Milliseconds(referenceTime) / RUNS;
+	bool passed = notFinite == 0 && notOrthonormal == 0 && flippedSigns == 0 && worst <= FRAME_BOUND;
+	printf("%-16s %7zu vertices %7zu triangles | Generate %8.3f ms | scalar %8.3f ms | %.2fx | worst %.6f deg | mirrored %d | not finite %d | not orthonormal %d | flipped %d %s\n",
+		name, source.size(), indices.size() / 3, generateMs, referenceMs, referenceMs / generateMs, worst,
+		mirrored, notFinite, notOrthonormal, flippedSigns, passed ? "ok" : "FAILED");
+	if (!passed)
+		failures++;
+}
+
+static void RunSpheres(const char* name, int rings, int sectors)
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	AddSphere(vertices, indices, rings, sectors, -2.0f, false);
+	AddSphere(vertices, indices, rings, sectors, 2.0f, true);
+	Run(name, vertices, indices);
+}
+
+int main()
+{
+	printf("Average of %d runs, frames checked against the scalar loop within %g degrees\n", RUNS, FRAME_BOUND);
+	RunSpheres("spheres 1k", 15, 31);
+	RunSpheres("spheres 16k", 63, 127);
+	RunSpheres("spheres 260k", 255, 511);
+
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	AddBrokenTriangles(vertices, indices);
+	Run("broken triangles", vertices, indices);
+
+	if (failures > 0)
+	{
+		printf("%d meshes failed\n", failures);
+		return 1;
+	}
+
+	printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+*  Replays a recorded input log through the simulation with no window, as fast as it can step.
+*
+*  Builds without the game, from the repository root:
+*    g++ -std=c++14 -O2 -I. Tools/Replay/ReplaySession.cpp Simulation/InputLog.cpp Simulation/InputReplay.cpp Simulation/SnakeSimulation.cpp Simulation/SnakeBody.cpp Simulation/SnakeTrail.cpp Simulation/SpatialHash.cpp Simulation/SelfCollisionHash.cpp Simulation/PickupField.cpp Simulation/SimRandom.cpp
+*    cl /std:c++14 /O2 /EHsc /I. Tools\Replay\ReplaySession.cpp Simulation\InputLog.cpp Simulation\InputReplay.cpp Simulation\SnakeSimulation.cpp Simulation\SnakeBody.cpp Simulation\SnakeTrail.cpp Simulation\SpatialHash.cpp Simulation\SelfCollisionHash.cpp Simulation\PickupField.cpp Simulation\SimRandom.cpp
+*
+*  Usage: ReplaySession <log file> [repeat count]
+*  The game writes the log of the last session to last_session.s3di in its working directory when it closes.
+*  Exits with 1 if the replay does not end in the same state as the recording.
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Simulation/InputLog.h"
+#include "Simulation/InputReplay.h"
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <log file> [repeat count]\n", argv[0]);
+		return 2;
+	}
+
+	InputLog log;
+	if (!log.Load(argv[1]))
+	{
+		printf("Failed to load input log %s\n", argv[1]);
+		return 2;
+	}
+	int repeat = (argc > 2) ? atoi(argv[2]) : 1;
+	if (repeat < 1)
+		repeat = 1;
+
+	printf("Seed %llu | %.1f ticks per second | %llu ticks | %u events in %zu bytes\n",
+		static_cast<unsigned long long>(log.GetSeed()), log.GetTickRate(), static_cast<unsigned long long>(log.GetEndTick()),
+		log.GetEventCount(), log.GetByteCount());
+
+	bool matches = true;
+	double total = 0.0;
+	for (int i = 0; i < repeat; i++)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		InputReplay replay(log);
+		replay.Run();
+		total += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		if (i == 0)
+		{
+			const SnakeSimulation& simulation = replay.GetSimulation();
+			printf("Score %d | game over at tick %llu | state %s the recording\n", simulation.GetScore(),
+				static_cast<unsigned long long>(replay.GetGameOverTick()), replay.MatchesRecording() ? "matches" : "DOES NOT match");
+		}
+		matches = matches && replay.MatchesRecording();
+	}
+
+	double average = total / repeat;
+	double recorded = (log.GetEndTick() * 1000.0) / log.GetTickRate();
+	printf("Replay %.3f ms on average over %d runs | recorded %.1f s | %.0fx real time\n",
+		average, repeat, recorded / 1000.0, (average > 0.0) ? recorded / average : 0.0);
+	return matches ? 0 : 1;
+}
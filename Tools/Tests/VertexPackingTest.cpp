@@ -0,0 +1,206 @@
+/*
+*  Checks the error bounds documented in VertexPacking.h on the CPU side encode and decode.
+*
+*  Builds without the game or D3D, from the repository root (DirectXMath is header only, on Linux
+*  it also needs sal.h from DirectX-Headers):
+*    g++ -std=c++14 -O2 -I. -I<DirectXMath>/Inc Tools/Tests/VertexPackingTest.cpp Assets/VertexPacking.cpp
+*    cl /std:c++14 /O2 /EHsc /I. /IIncludes Tools\Tests\VertexPackingTest.cpp Assets\VertexPacking.cpp
+*
+*  Directions are random on the sphere plus the axes and the edges the octahedron folds along,
+*  texture coordinates cover [-2, 2] where a half float step is at most 2^-10.
+*  Exits with 1 if any bound is exceeded.
+*/
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Assets/VertexPacking.h"
+
+using namespace DirectX;
+
+constexpr uint32_t SEED = 0x53334450;
+constexpr int DIRECTIONS = 1000000;
+constexpr float NORMAL_BOUND = 0.05f;  // Degrees
+constexpr float TANGENT_BOUND = 0.25f; // Degrees
+constexpr float TEXCOORD_BOUND = 1.0f / 2048.0f;
+constexpr float RADIANS_TO_DEGREES = 57.29577951f;
+
+static int failures = 0;
+
+static void Report(const char* name, double worst, double bound)
+{
+	bool passed = worst <= bound;
+	printf("%-34s worst %.8g bound %.8g %s\n", name, worst, bound, passed ? "ok" : "FAILED");
+	if (!passed)
+		failures++;
+}
+
+static float Dot(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+static XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3((a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x));
+}
+
+static XMFLOAT3 Normalize(const XMFLOAT3& v)
+{
+	float length = sqrtf(Dot(v, v));
+	return XMFLOAT3(v.x / length, v.y / length, v.z / length);
+}
+
+// Angle between two unit vectors, in double so the measurement adds no error of its own
+static double AngleDegrees(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	double cx = ((double)a.y * b.z) - ((double)a.z * b.y);
+	double cy = ((double)a.z * b.x) - ((double)a.x * b.z);
+	double cz = ((double)a.x * b.y) - ((double)a.y * b.x);
+	double dot = ((double)a.x * b.x) + ((double)a.y * b.y) + ((double)a.z * b.z);
+	return atan2(sqrt((cx * cx) + (cy * cy) + (cz * cz)), dot) * RADIANS_TO_DEGREES;
+}
+
+static std::vector<XMFLOAT3> CreateDirections(std::mt19937& random)
+{
+	std::vector<XMFLOAT3> directions;
+	std::normal_distribution<float> gaussian;
+	for (int i = 0; i < DIRECTIONS; i++)
+	{
+		XMFLOAT3 v(gaussian(random), gaussian(random), gaussian(random));
+		if (Dot(v, v) > 1e-12f)
+			directions.push_back(Normalize(v));
+	}
+
+	// Axes, diagonals and the folded edges, every sign combination
+	const float edges[][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 1, 0 }, { 1, 0, 1 }, { 0, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1e-4f } };
+	for (const float* edge : edges)
+	{
+		for (int signs = 0; signs < 8; signs++)
+		{
+			XMFLOAT3 v((signs & 1) ? -edge[0] : edge[0], (signs & 2) ? -edge[1] : edge[1], (signs & 4) ? -edge[2] : edge[2]);
+			directions.push_back(Normalize(v));
+		}
+	}
+	return directions;
+}
+
+// Every half value, NaNs have to stay NaN
+static void TestHalf()
+{
+	int mismatches = 0;
+	for (uint32_t half = 0; half <= 0xFFFF; half++)
+	{
+		float value = VertexPacking::HalfToFloat(static_cast<uint16_t>(half));
+		uint16_t back = VertexPacking::FloatToHalf(value);
+		bool isNaN = ((half & 0x7C00) == 0x7C00) && ((half & 0x03FF) != 0);
+		bool same = isNaN ? (std::isnan(value) && ((back & 0x7C00) == 0x7C00) && ((back & 0x03FF) != 0)) : (back == half);
+		if (!same)
+			mismatches++;
+	}
+	Report("half round trip mismatches", mismatches, 0);
+}
+
+static void TestNormals(const std::vector<XMFLOAT3>& directions)
+{
+	double worst = 0.0;
+	for (const XMFLOAT3& direction : directions)
+	{
+		Vertex vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, direction.x, direction.y, direction.z, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+		Vertex unpacked = VertexPacking::Unpack(VertexPacking::Pack(vertex));
+		worst = fmax(worst, AngleDegrees(direction, unpacked.normal));
+	}
+	Report("normal error (degrees)", worst, NORMAL_BOUND);
+}
+
+// Frames are the direction as tangent with a normal perpendicular to it, half of them mirrored
+static void TestTangents(const std::vector<XMFLOAT3>& directions)
+{
+	double worst = 0.0;
+	int flippedSigns = 0;
+	for (size_t i = 0; i < directions.size(); i++)
+	{
+		const XMFLOAT3& tangent = directions[i];
+		XMFLOAT3 axis = (fabsf(tangent.x) < 0.9f) ? XMFLOAT3(1.0f, 0.0f, 0.0f) : XMFLOAT3(0.0f, 1.0f, 0.0f);
+		XMFLOAT3 normal = Normalize(Cross(tangent, axis));
+		XMFLOAT3 binormal = Cross(normal, tangent);
+		float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+
+		Vertex vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, normal.x, normal.y, normal.z, tangent.x, tangent.y, tangent.z,
+			binormal.x * sign, binormal.y * sign, binormal.z * sign);
+		Vertex unpacked = VertexPacking::Unpack(VertexPacking::Pack(vertex));
+		worst = fmax(worst, AngleDegrees(tangent, unpacked.tangent));
+		if (Dot(unpacked.biNormal, vertex.biNormal) <= 0.0f)
+			flippedSigns++;
+	}
+	Report("tangent error (degrees)", worst, TANGENT_BOUND);
+	Report("binormal signs flipped", flippedSigns, 0);
+}
+
+static void TestTexCoords(std::mt19937& random)
+{
+	std::uniform_real_distribution<float> range(-2.0f, 2.0f);
+	double worst = 0.0;
+	for (int i = 0; i < DIRECTIONS; i++)
+	{
+		XMFLOAT2 texCoord(range(random), range(random));
+		Vertex vertex(0.0f, 0.0f, 0.0f, texCoord.x, texCoord.y, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+		Vertex unpacked = VertexPacking::Unpack(VertexPacking::Pack(vertex));
+		worst = fmax(worst, fabs((double)unpacked.texCoord.x - texCoord.x));
+		worst = fmax(worst, fabs((double)unpacked.texCoord.y - texCoord.y));
+	}
+	Report("texture coordinate error", worst, TEXCOORD_BOUND);
+}
+
+/* Half a 16 bit step of the largest half extent, with float rounding of center + pos * scale on top.
+*  Runs on a mesh far from the origin and one around it */
+static void TestPositions(std::mt19937& random, const XMFLOAT3& offset, const XMFLOAT3& extent)
+{
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::vector<Vertex> vertices(DIRECTIONS / 10);
+	for (Vertex& vertex : vertices)
+	{
+		vertex = Vertex(offset.x + (unit(random) * extent.x), offset.y + (unit(random) * extent.y), offset.z + (unit(random) * extent.z),
+			0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	PositionQuantization quantization = VertexPacking::GetQuantization(vertices.data(), vertices.size());
+	double worst = 0.0;
+	for (const Vertex& vertex : vertices)
+	{
+		Vertex unpacked = VertexPacking::Unpack(VertexPacking::Quantize(vertex, quantization), quantization);
+		worst = fmax(worst, fabs((double)unpacked.pos.x - vertex.pos.x));
+		worst = fmax(worst, fabs((double)unpacked.pos.y - vertex.pos.y));
+		worst = fmax(worst, fabs((double)unpacked.pos.z - vertex.pos.z));
+	}
+
+	float magnitude = fmaxf(fabsf(quantization.center.x), fmaxf(fabsf(quantization.center.y), fabsf(quantization.center.z))) + quantization.scale;
+	double bound = (quantization.scale / 65534.0) + (2.0 * FLT_EPSILON * magnitude);
+	char name[64];
+	snprintf(name, sizeof(name), "position error (scale %g)", quantization.scale);
+	Report(name, worst, bound);
+}
+
+int main()
+{
+	std::mt19937 random(SEED);
+	std::vector<XMFLOAT3> directions = CreateDirections(random);
+
+	TestHalf();
+	TestNormals(directions);
+	TestTangents(directions);
+	TestTexCoords(random);
+	TestPositions(random, XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 2.0f, 0.5f));
+	TestPositions(random, XMFLOAT3(250.0f, -40.0f, 1200.0f), XMFLOAT3(300.0f, 10.0f, 80.0f));
+
+	if (failures > 0)
+	{
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+
+	printf("All checks passed\n");
+	return 0;
+}
@@ -30,6 +30,25 @@ cbuffer CameraBuffer : register(b3)
     float3 inCameraDir;
 };
 
+#ifdef PACKED_VERTEX
+// PackedVertex and QuantizedVertex, see Graphics/Vertex.h
+struct VS_INPUT
+{
+    float4 inPosition : POSITION;
+    float2 inTexCoord : TEXCOORD;
+    float2 inNormal : NORMAL;   // Octahedral
+    float4 inTangent : TANGENT; // Octahedral in xy, binormal sign in w
+};
+
+// Unfolds the octahedron, the inverse of VertexPacking::EncodeOctahedral
+float3 DecodeOctahedral(float2 e)
+{
+    float3 v = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    if (v.z < 0.0f)
+        v.xy = (1.0f - abs(v.yx)) * (v.xy >= 0.0f ? 1.0f : -1.0f);
+    return normalize(v);
+}
+#else
 struct VS_INPUT
 {
     float4 inPosition : POSITION;
@@ -38,6 +57,7 @@ struct VS_INPUT
     float3 inTangent : TANGENT;
     float3 inbiNormal : BINORMAL;
 };
+#endif
 
 struct VS_OUTPUT
 {
@@ -88,16 +108,26 @@ VS_OUTPUT main(VS_INPUT input)
     
     output.outTexCoord = input.inTexCoord;
     
+#ifdef PACKED_VERTEX
+    float3 normal = DecodeOctahedral(input.inNormal);
+    float3 tangent = DecodeOctahedral((input.inTangent.xy * 2.0f) - 1.0f);
+    float3 biNormal = cross(normal, tangent) * ((input.inTangent.w * 2.0f) - 1.0f);
+#else
+    float3 normal = input.inNormal;
+    float3 tangent = input.inTangent;
+    float3 biNormal = input.inbiNormal;
+#endif
+
     // Calculate the normal vector against the world matrix only and then normalize the final value.
-    output.outNormal = mul(input.inNormal, (float3x3) worldMatrix);
+    output.outNormal = mul(normal, (float3x3) worldMatrix);
     output.outNormal = normalize(output.outNormal);
     
     // Calculate the tangent vector against the world matrix only and then normalize the final value.
-    output.outTangent = mul(input.inTangent, (float3x3) worldMatrix);
+    output.outTangent = mul(tangent, (float3x3) worldMatrix);
     output.outTangent = normalize(output.outTangent);
 
     // Calculate the binormal vector against the world matrix only and then normalize the final value.
-    output.outbiNormal = mul(input.inbiNormal, (float3x3) worldMatrix);
+    output.outbiNormal = mul(biNormal, (float3x3) worldMatrix);
     output.outbiNormal = normalize(output.outbiNormal);
 
     // Determine the light position based on the position of the light and the position of the vertex in the world.
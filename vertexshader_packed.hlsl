@@ -0,0 +1,3 @@
+// Model vertex shader for PackedVertex and QuantizedVertex, see MODEL_VERTEX_FORMAT
+#define PACKED_VERTEX
+#include "vertexshader.hlsl"